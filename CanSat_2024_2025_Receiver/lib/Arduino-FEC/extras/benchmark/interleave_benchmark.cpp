@@ -0,0 +1,84 @@
+/* Host channel simulation for RS::Interleave: frame error rate against burst length.
+ *
+ * Build and run from this directory:
+ *   g++ -O2 -DNDEBUG -I../../src interleave_benchmark.cpp -o interleave_benchmark && ./interleave_benchmark
+ *
+ * Every trial interleaves `depth` shortened RS codewords (telemetry-sized messages),
+ * corrupts the interleaved stream with random bursts, deinterleaves and decodes every
+ * codeword. A frame error is a codeword that does not come back intact. A group gets a
+ * Poisson count of bursts (mean BURSTS_PER_GROUP, so some groups get none and some
+ * several), each at a random offset with a length drawn uniformly from 1 to 2L-1 for
+ * a mean of L bytes. Cells print the FER and the failed codewords out of trials * depth.
+ * A group without a burst always decodes, so the FER stays below 1 - e^-1 for one burst
+ * per group on average. */
+
+#include "RS-FEC.h"
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static const uint8_t MSG_LEN = 96;
+static const uint8_t ECC_LEN = 32;
+static const uint8_t PAYLOAD = 76;  // typical telemetry line plus separator
+static const size_t  SLOT    = PAYLOAD + ECC_LEN;
+static const double  BURSTS_PER_GROUP = 1.0;
+
+static std::mt19937 rng(1);
+
+static size_t frame_errors(RS::ReedSolomon<MSG_LEN, ECC_LEN>& rs, uint8_t depth, size_t mean_burst, int trials) {
+    std::vector<uint8_t> msgs(depth * PAYLOAD), slots(depth * SLOT), stream(depth * SLOT);
+    std::poisson_distribution<int> burst_count(BURSTS_PER_GROUP);
+    std::uniform_int_distribution<size_t> burst_length(1, 2 * mean_burst - 1);
+    uint8_t out[MSG_LEN];
+    size_t failed = 0;
+
+    for(int t = 0; t < trials; t++) {
+        for(size_t i = 0; i < msgs.size(); i++) msgs[i] = rng();
+        for(uint8_t d = 0; d < depth; d++) {
+            rs.EncodeShortened(&msgs[d * PAYLOAD], PAYLOAD, &slots[d * SLOT]);
+        }
+        RS::Interleave(slots.data(), depth, SLOT, stream.data());
+
+        /* Random bursts at random offsets, every byte in them replaced by noise */
+        for(int b = burst_count(rng); b > 0; b--) {
+            size_t len = burst_length(rng);
+            if(len > stream.size()) len = stream.size();
+            size_t start = rng() % (stream.size() - len + 1);
+            for(size_t k = 0; k < len; k++) stream[start + k] ^= 1 + rng() % 255;
+        }
+
+        RS::Deinterleave(stream.data(), depth, SLOT, slots.data());
+        for(uint8_t d = 0; d < depth; d++) {
+            if(rs.DecodeShortened(&slots[d * SLOT], PAYLOAD, out) != 0 ||
+               memcmp(out, &msgs[d * PAYLOAD], PAYLOAD) != 0)
+                failed++;
+        }
+    }
+    return failed;
+}
+
+int main() {
+    RS::ReedSolomon<MSG_LEN, ECC_LEN> rs;
+
+    const uint8_t depths[] = { 1, 2, 4, 8 };
+    const size_t bursts[] = { 8, 16, 24, 32, 48, 64, 96, 128, 192 };
+    const int trials = 2000;
+
+    printf("RS(%u+%u) shortened, Poisson(%.1f) bursts per group of mean length L, %d groups per cell\n",
+           PAYLOAD, ECC_LEN, BURSTS_PER_GROUP, trials);
+    printf("    L");
+    for(size_t d = 0; d < sizeof(depths); d++) printf("   D=%u FER  failed/codewords", depths[d]);
+    printf("\n");
+
+    for(size_t b = 0; b < sizeof(bursts) / sizeof(bursts[0]); b++) {
+        printf("%5zu", bursts[b]);
+        for(size_t d = 0; d < sizeof(depths); d++) {
+            const size_t failed = frame_errors(rs, depths[d], bursts[b], trials);
+            const size_t codewords = (size_t) trials * depths[d];
+            printf("   %8.4f %6zu/%-9zu", (double) failed / codewords, failed, codewords);
+        }
+        printf("\n");
+    }
+    return 0;
+}
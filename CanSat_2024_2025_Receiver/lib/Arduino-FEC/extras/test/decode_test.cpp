@@ -0,0 +1,98 @@
+/* Host regression checks for the RS-FEC decoder, exits non-zero on the first failing case.
+ *
+ * Build and run from this directory:
+ *   g++ -O1 -g -fsanitize=address,undefined -I../../src decode_test.cpp -o decode_test && ./decode_test
+ * Add -DNDEBUG to run the checks without the library asserts. */
+
+#include "RS-FEC.h"
+#include <cstdio>
+#include <cstdlib>
+
+static int failures = 0;
+
+static void check(bool ok, const char* name, int round) {
+    if(!ok) {
+        printf("FAIL %s (round %d)\n", name, round);
+        failures++;
+    }
+}
+
+/* Exactly ecc_length erasures, the most the code can take: every erased symbol is
+ * corrupted, and the erasures are spread over message and ecc alike */
+template <const uint8_t msg_length, const uint8_t ecc_length>
+static void check_full_erasures(const char* name, int rounds) {
+    const uint8_t cw_len = msg_length + ecc_length;
+    RS::ReedSolomon<msg_length, ecc_length> rs;
+    uint8_t msg[msg_length], cw[cw_len], out[msg_length], pos[ecc_length];
+
+    for(int r = 0; r < rounds; r++) {
+        for(uint8_t i = 0; i < msg_length; i++) msg[i] = rand();
+        rs.Encode(msg, cw);
+
+        /* distinct positions: one per stride, at a random offset inside it */
+        const uint8_t stride = cw_len / ecc_length;
+        for(uint8_t i = 0; i < ecc_length; i++) {
+            pos[i] = i * stride + rand() % stride;
+            cw[pos[i]] ^= 1 + rand() % 255;
+        }
+
+        RS::DecodeResult result;
+        const int status = rs.Decode(cw, out, pos, ecc_length, &result);
+        check(status == 0 && memcmp(out, msg, msg_length) == 0 && result.erasures == ecc_length, name, r);
+    }
+}
+
+/* Erased symbols whose true value is 0: once they are zeroed the syndromes vanish,
+ * and the zeroed codeword, not the received one, is the correction */
+template <const uint8_t msg_length, const uint8_t ecc_length>
+static void check_zero_erasures(const char* name, int rounds) {
+    const uint8_t cw_len = msg_length + ecc_length;
+    RS::ReedSolomon<msg_length, ecc_length> rs;
+    uint8_t msg[msg_length], cw[cw_len], out[msg_length], pos[ecc_length];
+
+    for(int r = 0; r < rounds; r++) {
+        for(uint8_t i = 0; i < msg_length; i++) msg[i] = rand();
+        const uint8_t count = 1 + rand() % ecc_length;
+        const uint8_t stride = msg_length / count;
+        for(uint8_t i = 0; i < count; i++) {
+            pos[i] = i * stride + rand() % stride;
+            msg[pos[i]] = 0;
+        }
+        rs.Encode(msg, cw);
+        for(uint8_t i = 0; i < count; i++) cw[pos[i]] = 1 + rand() % 255;
+
+        const int status = rs.Decode(cw, out, pos, count);
+        check(status == 0 && memcmp(out, msg, msg_length) == 0, name, r);
+    }
+}
+
+/* Erasure positions past the codeword and more erasures than ecc_length are rejected
+ * before the decoder touches its polynomials */
+static void check_bad_erasures() {
+    RS::ReedSolomon<10, 4> rs;
+    uint8_t msg[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}, cw[14], out[10];
+    rs.Encode(msg, cw);
+
+    RS::DecodeResult result;
+    uint8_t outside[2] = {3, 14};
+    check(rs.Decode(cw, out, outside, 2, &result) != 0 && result.status == RS::RESULT_BAD_ARGUMENT,
+          "RS<10,4> with an erasure outside the codeword", 0);
+
+    uint8_t too_many[5] = {0, 1, 2, 3, 4};
+    check(rs.Decode(cw, out, too_many, 5, &result) != 0 && result.status == RS::RESULT_TOO_MANY_ERRATA,
+          "RS<10,4> with 5 erasures", 0);
+}
+
+int main() {
+    srand(1);
+
+    check_full_erasures<96, 32>("RS<96,32> with 32 erasures", 500);
+    check_full_erasures<10, 4>("RS<10,4> with 4 erasures", 500);
+    check_full_erasures<64, 64>("RS<64,64> with 64 erasures", 100);
+    check_zero_erasures<10, 4>("RS<10,4> with erased zero symbols", 500);
+    check_zero_erasures<96, 32>("RS<96,32> with erased zero symbols", 500);
+    check_bad_erasures();
+
+    printf("%s\n", failures == 0 ? "All decoder checks passed" : "Decoder checks failed");
+    return failures == 0 ? 0 : 1;
+}
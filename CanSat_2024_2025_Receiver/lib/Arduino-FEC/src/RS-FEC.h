@@ -98,6 +98,12 @@ protected:
 #include <stdint.h>
 #include <string.h>
 
+/* SSSE3/AVX2 region kernels on the host, plain table lookups elsewhere */
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define RS_GF_SIMD 1
+#include <immintrin.h>
+#endif
+
 #if !defined DEBUG && !defined __CC_ARM
 #include <assert.h>
 #else
@@ -110,9 +116,9 @@ namespace RS {
 namespace gf {
 
 
-/* GF tables pre-calculated for 0x11d primitive polynomial */
+/* GF tables pre-calculated for 0x11d primitive polynomial (constexpr, kept in flash) */
 
-const uint8_t exp[512] = {
+constexpr uint8_t exp[512] = {
     0x1, 0x2, 0x4, 0x8, 0x10, 0x20, 0x40, 0x80, 0x1d, 0x3a, 0x74, 0xe8, 0xcd, 0x87, 0x13, 0x26, 0x4c,
     0x98, 0x2d, 0x5a, 0xb4, 0x75, 0xea, 0xc9, 0x8f, 0x3, 0x6, 0xc, 0x18, 0x30, 0x60, 0xc0, 0x9d,
     0x27, 0x4e, 0x9c, 0x25, 0x4a, 0x94, 0x35, 0x6a, 0xd4, 0xb5, 0x77, 0xee, 0xc1, 0x9f, 0x23, 0x46,
@@ -147,7 +153,7 @@ const uint8_t exp[512] = {
     0xb0, 0x7d, 0xfa, 0xe9, 0xcf, 0x83, 0x1b, 0x36, 0x6c, 0xd8, 0xad, 0x47, 0x8e, 0x1, 0x2
 };
 
-const uint8_t log[256] = {
+constexpr uint8_t log[256] = {
     0x0, 0x0, 0x1, 0x19, 0x2, 0x32, 0x1a, 0xc6, 0x3, 0xdf, 0x33, 0xee, 0x1b, 0x68, 0xc7, 0x4b, 0x4,
     0x64, 0xe0, 0xe, 0x34, 0x8d, 0xef, 0x81, 0x1c, 0xc1, 0x69, 0xf8, 0xc8, 0x8, 0x4c, 0x71, 0x5,
     0x8a, 0x65, 0x2f, 0xe1, 0x24, 0xf, 0x21, 0x35, 0x93, 0x8e, 0xda, 0xf0, 0x12, 0x82, 0x45, 0x1d,
@@ -176,7 +182,7 @@ const uint8_t log[256] = {
  * @param x - left operand
  * @param y - right operand
  * @return x + y */
-inline uint8_t add(uint8_t x, uint8_t y) {
+constexpr inline uint8_t add(uint8_t x, uint8_t y) {
     return x^y;
 }
 
@@ -185,7 +191,7 @@ inline uint8_t add(uint8_t x, uint8_t y) {
  * @param x - left operand
  * @param y - right operand
  * @return x - y */
-inline uint8_t sub(uint8_t x, uint8_t y) {
+constexpr inline uint8_t sub(uint8_t x, uint8_t y) {
     return x^y;
 }
 
@@ -193,7 +199,7 @@ inline uint8_t sub(uint8_t x, uint8_t y) {
  * @param x - left operand
  * @param y - rifht operand
  * @return x * y */
-inline uint8_t mul(uint16_t x, uint16_t y){
+constexpr inline uint8_t mul(uint16_t x, uint16_t y){
     if (x == 0 || y == 0)
         return 0;
     return exp[log[x] + log[y]];
@@ -203,7 +209,7 @@ inline uint8_t mul(uint16_t x, uint16_t y){
  * @param x - dividend
  * @param y - divisor
  * @return x / y */
-inline uint8_t div(uint8_t x, uint8_t y){
+constexpr inline uint8_t div(uint8_t x, uint8_t y){
     assert(y != 0);
     if(x == 0) return 0;
     return exp[(log[x] + 255 - log[y]) % 255];
@@ -213,7 +219,7 @@ inline uint8_t div(uint8_t x, uint8_t y){
  * @param x     - operand
  * @param power - power
  * @return x^power */
-inline uint8_t pow(uint8_t x, intmax_t power){
+constexpr inline uint8_t pow(uint8_t x, intmax_t power){
     intmax_t i = log[x];
     i *= power;
     i %= 255;
@@ -224,10 +230,121 @@ inline uint8_t pow(uint8_t x, intmax_t power){
 /* @brief Inversion in Galua Fields
  * @param x - number
  * @return inversion of x */
-inline uint8_t inverse(uint8_t x){
+constexpr inline uint8_t inverse(uint8_t x){
     return exp[255 - log[x]]; /* == div(1, x); */
 }
 
+/* ###########################
+ * # REGION (VECTOR) KERNELS #
+ * ########################### */
+
+#ifdef RS_GF_SIMD
+/* Split-nibble product tables: lo[c][n] = c * n, hi[c][n] = c * (n << 4),
+ * so c * x == lo[c][x & 0xf] ^ hi[c][x >> 4] (PSHUFB lookups on x86) */
+struct NibbleTables {
+    uint8_t lo[256][16];
+    uint8_t hi[256][16];
+};
+
+constexpr NibbleTables build_nibble_tables() {
+    NibbleTables t = {};
+    for(uint16_t c = 0; c < 256; c++) {
+        for(uint8_t n = 0; n < 16; n++) {
+            t.lo[c][n] = mul(c, n);
+            t.hi[c][n] = mul(c, n << 4);
+        }
+    }
+    return t;
+}
+
+inline const NibbleTables& nibble_tables() {
+    static constexpr NibbleTables tables = build_nibble_tables();
+    return tables;
+}
+#endif
+
+/* @brief Multiply-accumulate of a byte region by a scalar: dst[i] ^= c * src[i]
+ * @param *dst - destination region (must not partially overlap src)
+ * @param *src - source region
+ * @param c    - scalar
+ * @param len  - region length */
+inline void mul_add_region(uint8_t* dst, const uint8_t* src, uint8_t c, size_t len) {
+    size_t i = 0;
+    if(c == 0) return;
+    if(c == 1) {
+        for(; i < len; i++) dst[i] ^= src[i];
+        return;
+    }
+
+#ifdef RS_GF_SIMD
+    const NibbleTables& t = nibble_tables();
+    const __m128i lo128 = _mm_loadu_si128((const __m128i*) t.lo[c]);
+    const __m128i hi128 = _mm_loadu_si128((const __m128i*) t.hi[c]);
+#ifdef __AVX2__
+    const __m256i lo256  = _mm256_broadcastsi128_si256(lo128);
+    const __m256i hi256  = _mm256_broadcastsi128_si256(hi128);
+    const __m256i mask256 = _mm256_set1_epi8(0x0f);
+    for(; i + 32 <= len; i += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i l = _mm256_shuffle_epi8(lo256, _mm256_and_si256(s, mask256));
+        __m256i h = _mm256_shuffle_epi8(hi256, _mm256_and_si256(_mm256_srli_epi64(s, 4), mask256));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(d, _mm256_xor_si256(l, h)));
+    }
+#endif
+    const __m128i mask128 = _mm_set1_epi8(0x0f);
+    for(; i + 16 <= len; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i l = _mm_shuffle_epi8(lo128, _mm_and_si128(s, mask128));
+        __m128i h = _mm_shuffle_epi8(hi128, _mm_and_si128(_mm_srli_epi64(s, 4), mask128));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d, _mm_xor_si128(l, h)));
+    }
+#endif
+
+    /* Scalar tail (whole region on ESP32): log of the scalar is looked up once */
+    const uint16_t lc = log[c];
+    for(; i < len; i++) {
+        if(src[i] != 0)
+            dst[i] ^= exp[lc + log[src[i]]];
+    }
+}
+
+/* @brief Multiplication of a byte region by a scalar: dst[i] = c * src[i]
+ * @param *dst - destination region (may be equal to src)
+ * @param *src - source region
+ * @param c    - scalar
+ * @param len  - region length */
+inline void mul_region(uint8_t* dst, const uint8_t* src, uint8_t c, size_t len) {
+    size_t i = 0;
+    if(c == 0) {
+        memset(dst, 0, len);
+        return;
+    }
+    if(c == 1) {
+        if(dst != src) memmove(dst, src, len);
+        return;
+    }
+
+#ifdef RS_GF_SIMD
+    const NibbleTables& t = nibble_tables();
+    const __m128i lo128 = _mm_loadu_si128((const __m128i*) t.lo[c]);
+    const __m128i hi128 = _mm_loadu_si128((const __m128i*) t.hi[c]);
+    const __m128i mask128 = _mm_set1_epi8(0x0f);
+    for(; i + 16 <= len; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i l = _mm_shuffle_epi8(lo128, _mm_and_si128(s, mask128));
+        __m128i h = _mm_shuffle_epi8(hi128, _mm_and_si128(_mm_srli_epi64(s, 4), mask128));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(l, h));
+    }
+#endif
+
+    const uint16_t lc = log[c];
+    for(; i < len; i++) {
+        dst[i] = (src[i] != 0) ? exp[lc + log[src[i]]] : 0;
+    }
+}
+
 /* ##########################
  * # POLYNOMIALS OPERATIONS #
  * ########################## */
@@ -239,9 +356,7 @@ inline uint8_t inverse(uint8_t x){
 inline void
 poly_scale(const Poly *p, Poly *newp, uint16_t x) {
     newp->length = p->length;
-    for(uint16_t i = 0; i < p->length; i++){
-        newp->at(i) = mul(p->at(i), x);
-    }
+    mul_region(newp->ptr(), p->ptr(), x, p->length);
 }
 
 /* @brief Addition of two polynomials
@@ -274,9 +389,8 @@ poly_mul(const Poly *p, const Poly *q, Poly *newp) {
     /* Compute the polynomial multiplication (just like the outer product of two vectors,
      * we multiply each coefficients of p with all coefficients of q) */
     for(uint8_t j = 0; j < q->length; j++){
-        for(uint8_t i = 0; i < p->length; i++){
-            newp->at(i+j) ^= mul(p->at(i), q->at(j)); /* == r[i + j] = gf_add(r[i+j], gf_mul(p[i], q[j])) */
-        }
+        /* r[i + j] = gf_add(r[i+j], gf_mul(p[i], q[j])) for every i at once */
+        mul_add_region(newp->ptr() + j, p->ptr(), q->at(j), p->length);
     }
 }
 
@@ -297,10 +411,7 @@ poly_div(const Poly *p, const Poly *q, Poly *newp) {
     for(int i = 0; i < (p->length-(q->length-1)); i++){
         coef = newp->at(i);
         if(coef != 0){
-            for(uint8_t j = 1; j < q->length; j++){
-                if(q->at(j) != 0)
-                    newp->at(i+j) ^= mul(q->at(j), coef);
-            }
+            mul_add_region(newp->ptr() + i + 1, q->ptr() + 1, coef, q->length - 1);
         }
     }
 
@@ -332,6 +443,16 @@ poly_eval(const Poly *p, uint16_t x) {
 #include <string.h>
 #include <stdint.h>
 
+/* DecodeBatch can fan out over std::thread workers on the host */
+#if !defined ARDUINO && !defined RS_NO_THREADS
+#define RS_BATCH_THREADS 1
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
 #if !defined DEBUG && !defined __CC_ARM
 #include <assert.h>
 #else
@@ -340,140 +461,314 @@ poly_eval(const Poly *p, uint16_t x) {
 
 namespace RS {
 
-#define MSG_CNT 3   // message-length polynomials count
-#define POLY_CNT 14 // (ecc_length*2)-length polynomialc count
+#define MSG_CNT 3   // codeword-length polynomials count
+#define POLY_CNT 14 // (ecc_length*2+1)-length polynomialc count
 
-template <const uint8_t msg_length,  // Message length without correction code
-          const uint8_t ecc_length>  // Length of correction code
+/* Decoding status codes, see DecodeResult::status */
+enum DecodeStatus {
+    RESULT_SUCCESS = 0,
+    RESULT_BAD_ARGUMENT,     // message longer than msg_length or erasure outside the codeword
+    RESULT_TOO_MANY_ERRATA,  // more erasures than ecc_length
+    RESULT_LOCATOR_FAILED,   // no error locator fits, too many errors to correct
+    RESULT_PAD_CORRUPTED     // shortened code: a correction landed in the virtual zeros
+};
 
-class ReedSolomon {
-public:
-    ReedSolomon() {
-        const uint8_t   enc_len  = msg_length + ecc_length;
-        const uint8_t   poly_len = ecc_length * 2;
-        uint8_t** memptr   = &memory;
-        uint16_t  offset   = 0;
+/* Most errata positions kept in a DecodeResult, ecc_length never needs more */
+#ifndef RS_RESULT_POSITIONS
+#define RS_RESULT_POSITIONS 32
+#endif
 
-        /* Initialize first six polys manually cause their amount depends on template parameters */
+/* Per-codeword summary filled by Decode, DecodeShortened and DecodeBatch */
+struct DecodeResult {
+    int8_t  status;      // RESULT_SUCCESS (0) or a DecodeStatus failure
+    bool    corrected;   // false if the codeword had zero syndromes
+    uint8_t erasures;    // known erasures passed in
+    uint8_t errors;      // unknown errors located by the decoder
+    uint8_t positions[RS_RESULT_POSITIONS]; // codeword positions, erasures then errors
+};
 
-        polynoms[0].Init(ID_MSG_IN, offset, enc_len, memptr);
-        offset += enc_len;
+/* @brief Count of valid entries in DecodeResult::positions */
+inline uint8_t ResultPositions(const DecodeResult* result) {
+    const uint8_t count = result->erasures + result->errors;
+    return count < RS_RESULT_POSITIONS ? count : RS_RESULT_POSITIONS;
+}
 
-        polynoms[1].Init(ID_MSG_OUT, offset, enc_len, memptr);
-        offset += enc_len;
+/* @brief Resets a decoding summary before a decode attempt */
+inline void ClearResult(DecodeResult* result, DecodeStatus status) {
+    result->status    = status;
+    result->corrected = false;
+    result->erasures  = 0;
+    result->errors    = 0;
+}
 
-        for(uint8_t i = ID_GENERATOR; i < ID_MSG_E; i++) {
-            polynoms[i].Init(i, offset, poly_len, memptr);
-            offset += poly_len;
-        }
+#ifdef RS_BATCH_THREADS
+/* Fewest codewords a DecodeBatch thread gets, smaller batches use fewer threads or
+ * stay on the calling one. Handing a batch to the pool costs 10 to 30 us, a 96+32
+ * codeword about 0.7 us, so a slice of 256 keeps the hand-off near a tenth */
+#ifndef RS_BATCH_MIN_PER_THREAD
+#define RS_BATCH_MIN_PER_THREAD 256
+#endif
 
-        polynoms[5].Init(ID_MSG_E, offset, enc_len, memptr);
-        offset += enc_len;
+/* Worker threads kept by DecodeBatch between calls: started on first use, grown to
+ * the most threads asked for, joined at exit. One batch runs on them at a time */
+class BatchPool {
+public:
+    /* @brief The pool shared by every DecodeBatch */
+    static BatchPool& Instance() {
+        static BatchPool pool;
+        return pool;
+    }
 
-        for(uint8_t i = ID_TPOLY3; i < ID_ERR_EVAL+2; i++) {
-            polynoms[i].Init(i, offset, poly_len, memptr);
-            offset += poly_len;
+    /* @brief Runs job(0) to job(count-1), job(0) on the calling thread
+     * @return false without running anything if another batch holds the pool */
+    bool Run(unsigned count, const std::function<void(unsigned)>& job) {
+        std::unique_lock<std::mutex> owner(busy, std::try_to_lock);
+        if(!owner.owns_lock()) return false;
+
+        std::unique_lock<std::mutex> guard(lock);
+        while(workers.size() + 1 < count) workers.push_back(std::thread(&BatchPool::Work, this));
+        current = &job;
+        next    = 1;
+        total   = count;
+        pending = count - 1;
+        wake.notify_all();
+        guard.unlock();
+
+        job(0);
+
+        guard.lock();
+        done.wait(guard, [this]() { return pending == 0; });
+        current = NULL;
+        return true;
+    }
+
+    ~BatchPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stop = true;
         }
+        wake.notify_all();
+        for(size_t t = 0; t < workers.size(); t++) workers[t].join();
     }
 
-    ~ReedSolomon() {
-        // Dummy destructor, gcc-generated one crashes programm
-        memory = NULL;
+private:
+    BatchPool() : current(NULL), next(0), total(0), pending(0), stop(false) {}
+
+    void Work() {
+        std::unique_lock<std::mutex> guard(lock);
+        for(;;) {
+            wake.wait(guard, [this]() { return stop || next < total; });
+            if(stop) return;
+
+            const unsigned slice = next++;
+            const std::function<void(unsigned)>* job = current;
+            guard.unlock();
+            (*job)(slice);
+            guard.lock();
+
+            if(--pending == 0) done.notify_one();
+        }
     }
 
-    /* @brief Message block encoding
-     * @param *src - input message buffer      (msg_lenth size)
-     * @param *dst - output buffer for ecc     (ecc_length size at least) */
-     void EncodeBlock(const void* src, void* dst) {
-        assert(msg_length + ecc_length < 256);
+    std::mutex busy;               // held by the batch running on the pool
+    std::mutex lock;               // guards everything below
+    std::condition_variable wake;  // slices to take, or stop
+    std::condition_variable done;  // last slice finished
+    std::vector<std::thread> workers;
+    const std::function<void(unsigned)>* current;
+    unsigned next, total, pending; // next slice to hand out, slices of the batch, slices not finished
+    bool stop;
+};
+#endif
 
-        /* Generator cache, it dosn't change for one template parameters */
-        static uint8_t generator_cache[ecc_length+1] = {0};
-        static bool    generator_cached = false;
+/* Error locator core used by the decoder */
+enum DecoderCore {
+    CORE_POLY = 0,  // Poly based Berlekamp-Massey, locator evaluated at every position
+    CORE_TABLE      // inversionless Berlekamp-Massey on flat arrays, incremental Chien search
+};
 
-        /* Allocating memory on stack for polynomials storage */
-        uint8_t stack_memory[MSG_CNT * msg_length + POLY_CNT * ecc_length * 2];
-        this->memory = stack_memory;
+/* Generator polynomial (x - 2^0)(x - 2^1)...(x - 2^(ecc_length-1)),
+ * coefficients from the highest degree, plus their logarithms */
+template <const uint8_t ecc_length>
+struct Generator {
+    uint8_t coef[ecc_length + 1];
+    uint8_t log_coef[ecc_length + 1];
+};
 
-        const uint8_t* src_ptr = (const uint8_t*) src;
-        uint8_t* dst_ptr = (uint8_t*) dst;
+template <const uint8_t ecc_length>
+constexpr Generator<ecc_length> make_generator() {
+    Generator<ecc_length> gen = {};
+    gen.coef[0] = 1;
 
-        Poly *msg_in  = &polynoms[ID_MSG_IN];
-        Poly *msg_out = &polynoms[ID_MSG_OUT];
-        Poly *gen     = &polynoms[ID_GENERATOR];
+    for(uint8_t i = 0; i < ecc_length; i++) {
+        const uint8_t root = gf::pow(2, i);
+        /* gen = gen * (x + root), walking down so gen[j-1] is still the old value */
+        for(uint8_t j = i + 1; j > 0; j--) {
+            gen.coef[j] ^= gf::mul(gen.coef[j-1], root);
+        }
+    }
 
-        // Weird shit, but without reseting msg_in it simply doesn't work
-        msg_in->Reset();
-        msg_out->Reset();
+    for(uint8_t j = 0; j < ecc_length + 1; j++) {
+        gen.log_coef[j] = gf::log[gen.coef[j]];
+    }
+    return gen;
+}
 
-        // Using cached generator or generating new one
-        if(generator_cached) {
-            gen->Set(generator_cache, sizeof(generator_cache));
-        } else {
-            GeneratorPoly();
-            memcpy(generator_cache, gen->ptr(), gen->length);
-            generator_cached = true;
+/* Compile-time generator, one instance per ECC length (lives in flash) */
+template <const uint8_t ecc_length>
+struct GeneratorTable {
+    static constexpr Generator<ecc_length> poly = make_generator<ecc_length>();
+};
+
+template <const uint8_t ecc_length>
+constexpr Generator<ecc_length> GeneratorTable<ecc_length>::poly;
+
+/* Syndrome evaluation rows: row k holds 2^(r*(n-1-k)) for every root r (or its
+ * log when as_logs is set), so all syndromes take one pass over the codeword */
+template <const uint8_t code_length, const uint8_t ecc_length>
+struct SyndromeRows {
+    uint8_t row[code_length][ecc_length];
+};
+
+template <const uint8_t code_length, const uint8_t ecc_length, bool as_logs>
+constexpr SyndromeRows<code_length, ecc_length> make_syndrome_rows() {
+    SyndromeRows<code_length, ecc_length> rows = {};
+    for(uint16_t k = 0; k < code_length; k++) {
+        for(uint16_t r = 0; r < ecc_length; r++) {
+            const uint8_t e = (r * (code_length - 1 - k)) % 255;
+            rows.row[k][r] = as_logs ? e : gf::exp[e];
         }
+    }
+    return rows;
+}
 
-        // Copying input message to internal polynomial
-        msg_in->Set(src_ptr, msg_length);
-        msg_out->Set(src_ptr, msg_length);
-        msg_out->length = msg_in->length + ecc_length;
-
-        // Here all the magic happens
-        uint8_t coef = 0; // cache
-        for(uint8_t i = 0; i < msg_length; i++){
-            coef = msg_out->at(i);
-            if(coef != 0){
-                for(uint32_t j = 1; j < gen->length; j++){
-                    msg_out->at(i+j) ^= gf::mul(gen->at(j), coef);
-                }
+/* Only the table a target actually uses gets instantiated (powers with SIMD, logs on the ESP32) */
+template <const uint8_t code_length, const uint8_t ecc_length>
+struct SyndromeTable {
+    static constexpr SyndromeRows<code_length, ecc_length> powers = make_syndrome_rows<code_length, ecc_length, false>();
+    static constexpr SyndromeRows<code_length, ecc_length> logs   = make_syndrome_rows<code_length, ecc_length, true>();
+};
+
+template <const uint8_t code_length, const uint8_t ecc_length>
+constexpr SyndromeRows<code_length, ecc_length> SyndromeTable<code_length, ecc_length>::powers;
+
+template <const uint8_t code_length, const uint8_t ecc_length>
+constexpr SyndromeRows<code_length, ecc_length> SyndromeTable<code_length, ecc_length>::logs;
+
+/* Systematic LFSR encoder driven directly by the compile-time generator */
+template <const uint8_t msg_length,
+          const uint8_t ecc_length>
+struct LFSREncoder {
+    /* @brief Computes the ecc of a message
+     * @param *msg - input message    (msg_length size)
+     * @param *ecc - output ecc       (ecc_length size at least) */
+    static void Encode(const uint8_t* msg, uint8_t* ecc) {
+        const Generator<ecc_length>& gen = GeneratorTable<ecc_length>::poly;
+
+        /* Remainder window slides over the message, no polynomial copies needed */
+        uint8_t reg[msg_length + ecc_length];
+        memcpy(reg, msg, msg_length);
+        memset(reg + msg_length, 0, ecc_length);
+
+        uint8_t coef;
+        for(uint8_t i = 0; i < msg_length; i++) {
+            coef = reg[i];
+            if(coef == 0) continue;
+#ifdef RS_GF_SIMD
+            gf::mul_add_region(reg + i + 1, gen.coef + 1, coef, ecc_length);
+#else
+            /* Generator coefficients are never zero, so their logs are used directly */
+            const uint16_t lc = gf::log[coef];
+            for(uint8_t j = 1; j < ecc_length + 1; j++) {
+                reg[i+j] ^= gf::exp[gen.log_coef[j] + lc];
             }
+#endif
         }
 
-        // Copying ECC to the output buffer
-        memcpy(dst_ptr, msg_out->ptr()+msg_length, ecc_length * sizeof(uint8_t));
+        memcpy(ecc, reg + msg_length, ecc_length);
     }
+};
 
-    /* @brief Message encoding
-     * @param *src - input message buffer      (msg_lenth size)
-     * @param *dst - output buffer             (msg_length + ecc_length size at least) */
-    void Encode(const void* src, void* dst) {
-        uint8_t* dst_ptr = (uint8_t*) dst;
+/* Polynomial memory and scratch polynomials of one decoding. ReedSolomon keeps no
+ * decoding state, so threads that decode at the same time only need a workspace each */
+template <const uint8_t msg_length,
+          const uint8_t ecc_length>
+class DecoderWorkspace {
+public:
+    DecoderWorkspace() {
+        memory = storage;
 
-        // Copying message to the output buffer
-        memcpy(dst_ptr, src, msg_length * sizeof(uint8_t));
+        const uint8_t   enc_len  = ENC_LEN;
+        const uint8_t   poly_len = POLY_LEN;
+        uint8_t** memptr   = &memory;
+        uint16_t  offset   = 0;
 
-        // Calling EncodeBlock to write ecc to out[ut buffer
-        EncodeBlock(src, dst_ptr+msg_length);
-    }
+        /* Initialize first six polys manually cause their amount depends on template parameters */
 
-    /* @brief Message block decoding
-     * @param *src         - encoded message buffer   (msg_length size)
-     * @param *ecc         - ecc buffer               (ecc_length size)
-     * @param *msg_out     - output buffer            (msg_length size at least)
-     * @param *erase_pos   - known errors positions
-     * @param erase_count  - count of known errors
-     * @return RESULT_SUCCESS if successfull, error code otherwise */
-     int DecodeBlock(const void* src, const void* ecc, void* dst, uint8_t* erase_pos = NULL, size_t erase_count = 0) {
-        assert(msg_length + ecc_length < 256);
+        polynoms[0].Init(ID_MSG_IN, offset, enc_len, memptr);
+        offset += enc_len;
+
+        polynoms[1].Init(ID_MSG_OUT, offset, enc_len, memptr);
+        offset += enc_len;
+
+        for(uint8_t i = ID_GENERATOR; i < ID_MSG_E; i++) {
+            polynoms[i].Init(i, offset, poly_len, memptr);
+            offset += poly_len;
+        }
 
-        const uint8_t *src_ptr = (const uint8_t*) src;
-        const uint8_t *ecc_ptr = (const uint8_t*) ecc;
-        uint8_t *dst_ptr = (uint8_t*) dst;
+        polynoms[5].Init(ID_MSG_E, offset, enc_len, memptr);
+        offset += enc_len;
 
+        for(uint8_t i = ID_TPOLY3; i < ID_ERR_EVAL+2; i++) {
+            polynoms[i].Init(i, offset, poly_len, memptr);
+            offset += poly_len;
+        }
+    }
+
+    // Polynomials point into this instance
+    DecoderWorkspace(const DecoderWorkspace&) = delete;
+    DecoderWorkspace& operator=(const DecoderWorkspace&) = delete;
+
+    /* @brief Codeword decoding with this workspace's polynomials
+     * @param core    - error locator core
+     * @param *result - optional decoding summary
+     * @return RESULT_SUCCESS if successfull, error code otherwise */
+    int DecodeCodeword(const uint8_t* src_ptr, const uint8_t* ecc_ptr, uint8_t* dst_ptr,
+                       uint8_t* erase_pos, size_t erase_count, DecoderCore core, DecodeResult* result) {
         const uint8_t src_len = msg_length + ecc_length;
         const uint8_t dst_len = msg_length;
 
         bool ok;
 
-        /* Allocation memory on stack */
-        uint8_t stack_memory[MSG_CNT * msg_length + POLY_CNT * ecc_length * 2];
-        this->memory = stack_memory;
+        if(result != NULL) ClearResult(result, RESULT_TOO_MANY_ERRATA);
 
         Poly *msg_in  = &polynoms[ID_MSG_IN];
         Poly *msg_out = &polynoms[ID_MSG_OUT];
         Poly *epos    = &polynoms[ID_ERASURES];
+        Poly *synd    = &polynoms[ID_SYNDROMES];
+
+        bool has_errors = true;
+
+        // Erasures are checked before any of them is copied or zeroed
+        if(erase_pos != NULL && erase_count > 0) {
+            if(erase_count > ecc_length) return 1;
+            for(size_t i = 0; i < erase_count; i++) {
+                if(erase_pos[i] >= src_len) {
+                    if(result != NULL) result->status = RESULT_BAD_ARGUMENT;
+                    return 1;
+                }
+            }
+        }
+
+        // Clean codewords leave before any polynomial is touched
+        if(erase_pos == NULL || erase_count == 0) {
+            has_errors = CalcSyndromes(src_ptr, ecc_ptr);
+            if(!has_errors) {
+                memcpy(dst_ptr, src_ptr, dst_len * sizeof(uint8_t));
+                if(result != NULL) result->status = RESULT_SUCCESS;
+                return 0;
+            }
+        }
 
         // Copying message to polynomials memory
         msg_in->Set(src_ptr, msg_length);
@@ -490,46 +785,53 @@ public:
             }
         }
 
-        // Too many errors
-        if(epos->length > ecc_length) return 1;
+        if(result != NULL) result->erasures = epos->length;
 
-        Poly *synd   = &polynoms[ID_SYNDROMES];
         Poly *eloc   = &polynoms[ID_ERRORS_LOC];
         Poly *reloc  = &polynoms[ID_TPOLY1];
         Poly *err    = &polynoms[ID_ERRORS];
         Poly *forney = &polynoms[ID_FORNEY];
 
-        // Calculating syndrome
-        CalcSyndromes(msg_in);
-
-        // Checking for errors
-        bool has_errors = false;
-        for(uint8_t i = 0; i < synd->length; i++) {
-            if(synd->at(i) != 0) {
-                has_errors = true;
-                break;
-            }
+        // Erased symbols were zeroed, so the syndromes are taken again
+        if(epos->length > 0) {
+            has_errors = CalcSyndromes(msg_in->ptr(), msg_in->ptr() + msg_length);
         }
 
-        // Going to exit if no errors
-        if(!has_errors) goto return_corrected_msg;
+        // Going to exit if no errors; msg_in, with the erased symbols zeroed, is then the codeword
+        if(!has_errors) {
+            msg_out->Copy(msg_in);
+            goto return_corrected_msg;
+        }
+        if(result != NULL) result->corrected = true;
 
         CalcForneySyndromes(synd, epos, src_len);
-        FindErrorLocator(forney, NULL, epos->length);
 
-        // Reversing syndrome
-        // TODO optimize through special Poly flag
-        reloc->length = eloc->length;
-        for(int8_t i = eloc->length-1, j = 0; i >= 0; i--, j++){
-            reloc->at(j) = eloc->at(i);
-        }
+        if(core == CORE_TABLE) {
+            ok = FindErrorsTable(forney->ptr(), epos->length, src_len);
+        } else {
+            FindErrorLocator(forney, NULL, epos->length);
+
+            // Reversing syndrome
+            // TODO optimize through special Poly flag
+            reloc->length = eloc->length;
+            for(int8_t i = eloc->length-1, j = 0; i >= 0; i--, j++){
+                reloc->at(j) = eloc->at(i);
+            }
 
-        // Fing errors
-        ok = FindErrors(reloc, src_len);
-        if(!ok) return 1;
+            // Fing errors
+            ok = FindErrors(reloc, src_len);
+        }
+        if(!ok) {
+            if(result != NULL) result->status = RESULT_LOCATOR_FAILED;
+            return 1;
+        }
 
-        // Error happened while finding errors (so helpfull :D)
-        if(err->length == 0) return 1;
+        // Error happened while finding errors (so helpfull :D),
+        // unless every error was a known erasure
+        if(err->length == 0 && epos->length == 0) {
+            if(result != NULL) result->status = RESULT_LOCATOR_FAILED;
+            return 1;
+        }
 
         /* Adding found errors with known */
         for(uint8_t i = 0; i < err->length; i++) {
@@ -539,26 +841,22 @@ public:
         // Correcting errors
         CorrectErrata(synd, epos, msg_in);
 
+        if(result != NULL) result->errors = err->length;
+
     return_corrected_msg:
+        if(result != NULL) {
+            for(uint8_t i = 0; i < epos->length && i < RS_RESULT_POSITIONS; i++) {
+                result->positions[i] = epos->at(i);
+            }
+        }
+
         // Wrighting corrected message to output buffer
         msg_out->length = dst_len;
         memcpy(dst_ptr, msg_out->ptr(), msg_out->length * sizeof(uint8_t));
+        if(result != NULL) result->status = RESULT_SUCCESS;
         return 0;
     }
 
-    /* @brief Message block decoding
-     * @param *src         - encoded message buffer   (msg_length + ecc_length size)
-     * @param *msg_out     - output buffer            (msg_length size at least)
-     * @param *erase_pos   - known errors positions
-     * @param erase_count  - count of known errors
-     * @return RESULT_SUCCESS if successfull, error code otherwise */
-     int Decode(const void* src, void* dst, uint8_t* erase_pos = NULL, size_t erase_count = 0) {
-         const uint8_t *src_ptr = (const uint8_t*) src;
-         const uint8_t *ecc_ptr = src_ptr + msg_length;
-
-         return DecodeBlock(src, ecc_ptr, dst, erase_pos, erase_count);
-     }
-
 #ifndef DEBUG
 private:
 #endif
@@ -588,35 +886,51 @@ private:
         ID_ERR_EVAL
     };
 
-    // Pointer for polynomials memory on stack
+    /* Codeword polynomials hold msg_length + ecc_length symbols. The others hold up to
+     * ecc_length*2+1: with ecc_length erasures the syndromes times the errata locator
+     * have (ecc_length+1) + (ecc_length+1) - 1 coefficients */
+    static const uint8_t ENC_LEN  = msg_length + ecc_length;
+    static const uint8_t POLY_LEN = ecc_length * 2 + 1;
+
+    // Polynomials memory, on the stack of the decoding call
+    uint8_t  storage[MSG_CNT * ENC_LEN + POLY_CNT * POLY_LEN];
     uint8_t* memory;
     Poly polynoms[MSG_CNT + POLY_CNT];
 
-    void GeneratorPoly() {
-        Poly *gen = polynoms + ID_GENERATOR;
-        gen->at(0) = 1;
-        gen->length = 1;
-
-        Poly *mulp = polynoms + ID_TPOLY1;
-        Poly *temp = polynoms + ID_TPOLY2;
-        mulp->length = 2;
-
-        for(int8_t i = 0; i < ecc_length; i++){
-            mulp->at(0) = 1;
-            mulp->at(1) = gf::pow(2, i);
+    /* @brief Evaluates the codeword in all ecc_length roots in a single pass
+     * @param *msg - message part of the codeword (msg_length size)
+     * @param *ecc - ecc part of the codeword     (ecc_length size)
+     * @return false if every syndrome is zero (codeword has no errors) */
+    bool CalcSyndromes(const uint8_t* msg, const uint8_t* ecc) {
+        Poly *synd = &polynoms[ID_SYNDROMES];
+        synd->length = ecc_length+1;
+        memset(synd->ptr(), 0, ecc_length+1);
 
-            gf::poly_mul(gen, mulp, temp);
+        uint8_t* s = synd->ptr() + 1;
+        AccumulateSyndromes(s, msg, 0, msg_length);
+        AccumulateSyndromes(s, ecc, msg_length, ecc_length);
 
-            gen->Copy(temp);
-        }
+        uint8_t any = 0;
+        for(uint8_t i = 0; i < ecc_length; i++) any |= s[i];
+        return any != 0;
     }
 
-    void CalcSyndromes(const Poly *msg) {
-        Poly *synd = &polynoms[ID_SYNDROMES];
-        synd->length = ecc_length+1;
-        synd->at(0) = 0;
-        for(uint8_t i = 1; i < ecc_length+1; i++){
-            synd->at(i) = gf::poly_eval(msg, gf::pow(2, i-1));
+    /* @brief Adds symbols [first, first+count) of the codeword to all syndromes
+     * s[r] ^= c[k] * 2^(r*(n-1-k)), one table row per symbol */
+    void AccumulateSyndromes(uint8_t* s, const uint8_t* symbols, uint8_t first, uint8_t count) {
+        typedef SyndromeTable<msg_length + ecc_length, ecc_length> table;
+        for(uint8_t k = 0; k < count; k++) {
+            const uint8_t c = symbols[k];
+            if(c == 0) continue;
+#ifdef RS_GF_SIMD
+            gf::mul_add_region(s, table::powers.row[first + k], c, ecc_length);
+#else
+            const uint16_t lc = gf::log[c];
+            const uint8_t* lrow = table::logs.row[first + k];
+            for(uint8_t r = 0; r < ecc_length; r++) {
+                s[r] ^= gf::exp[lc + lrow[r]];
+            }
+#endif
         }
     }
 
@@ -823,6 +1137,89 @@ private:
         return true;
     }
 
+    /* @brief Inversionless Berlekamp-Massey on the Forney syndromes plus a Chien search,
+     *        fills ID_ERRORS the same way FindErrorLocator + FindErrors do
+     * @param *fsynd       - Forney syndromes   (ecc_length size)
+     * @param erase_count  - count of known erasures
+     * @param msg_in_size  - codeword length
+     * @return false if the locator does not have exactly deg(lambda) roots in the codeword */
+    bool FindErrorsTable(const uint8_t* fsynd, uint8_t erase_count, uint8_t msg_in_size) {
+        Poly *err = &polynoms[ID_ERRORS];
+        err->length = 0;
+
+        /* Lowest degree first; deg(lambda) never exceeds the iteration count, so ecc_length+1 fits */
+        uint8_t lambda[ecc_length + 1];
+        uint8_t prev[ecc_length + 1];
+        uint8_t b[ecc_length + 1];
+        memset(lambda, 0, sizeof(lambda));
+        memset(b, 0, sizeof(b));
+        lambda[0] = 1;
+        b[0] = 1;
+
+        uint8_t gamma = 1;
+        int16_t k = 0;
+        uint8_t delta;
+
+        for(uint8_t r = 0; r < ecc_length - erase_count; r++) {
+            delta = 0;
+            for(uint8_t j = 0; j <= r; j++) {
+                delta ^= gf::mul(lambda[j], fsynd[r - j]);
+            }
+
+            /* lambda = gamma*lambda - delta*x*b, no field inversion needed.
+             * With delta == 0 the gamma scaling is skipped, it leaves the roots alone */
+            if(delta != 0) {
+                memcpy(prev, lambda, sizeof(lambda));
+                gf::mul_region(lambda, lambda, gamma, ecc_length + 1);
+                gf::mul_add_region(lambda + 1, b, delta, ecc_length);
+            }
+
+            if(delta != 0 && k >= 0) {
+                memcpy(b, prev, sizeof(prev));
+                gamma = delta;
+                k = -k - 1;
+            } else {
+                memmove(b + 1, b, ecc_length);
+                b[0] = 0;
+                k++;
+            }
+        }
+
+        uint8_t errs = ecc_length;
+        while(errs > 0 && lambda[errs] == 0) errs--;
+        if(errs * 2 + erase_count > ecc_length) {
+            return false; /* Error count is greater then we can fix! */
+        }
+
+        /* Chien search: term j holds log(lambda[j] * 2^(-i*j)) and steps by -j,
+         * so every position costs one add and one table lookup per term */
+        uint16_t term_log[ecc_length];
+        uint8_t  term_step[ecc_length];
+        uint8_t  terms = 0;
+        for(uint8_t j = 1; j <= errs; j++) {
+            if(lambda[j] == 0) continue;
+            term_log[terms]  = gf::log[lambda[j]];
+            term_step[terms] = 255 - j;
+            terms++;
+        }
+
+        uint8_t sum;
+        for(uint16_t i = 0; i < msg_in_size && err->length < errs; i++) {
+            sum = lambda[0];
+            for(uint8_t t = 0; t < terms; t++) {
+                sum ^= gf::exp[term_log[t]];
+                term_log[t] += term_step[t];
+                if(term_log[t] >= 255) term_log[t] -= 255;
+            }
+            if(sum == 0) {
+                err->Append(msg_in_size - 1 - i);
+            }
+        }
+
+        /* Same sanity check as FindErrors */
+        return err->length == errs;
+    }
+
     void CalcForneySyndromes(const Poly *synd, const Poly *erasures_pos, size_t msg_in_size) {
         Poly *erase_pos_reversed = &polynoms[ID_TPOLY1];
         Poly *forney_synd = &polynoms[ID_FORNEY];
@@ -835,13 +1232,249 @@ private:
         forney_synd->Reset();
         forney_synd->Set(synd->ptr()+1, synd->length-1);
 
+        /* f[j] = f[j] * x + f[j+1]: shifted copy plus one multiply-accumulate pass */
+        uint8_t* shifted = polynoms[ID_TPOLY2].ptr();
+        uint8_t* f = forney_synd->ptr();
+        const uint8_t n = forney_synd->length - 1;
         uint8_t x;
         for(uint8_t i = 0; i < erasures_pos->length; i++) {
             x = gf::pow(2, erase_pos_reversed->at(i));
-            for(int8_t j = 0; j < forney_synd->length - 1; j++){
-                forney_synd->at(j) = gf::mul(forney_synd->at(j), x) ^ forney_synd->at(j+1);
+            memcpy(shifted, f + 1, n);
+            gf::mul_add_region(shifted, f, x, n);
+            memcpy(f, shifted, n);
+        }
+    }
+};
+
+template <const uint8_t msg_length,  // Message length without correction code
+          const uint8_t ecc_length>  // Length of correction code
+
+class ReedSolomon {
+public:
+    typedef DecoderWorkspace<msg_length, ecc_length> Workspace;
+
+    /* Encoding and decoding only read the instance, so one codec can be shared by
+     * many threads; SetDecoderCore must not race with them */
+    ReedSolomon()
+        : core(CORE_TABLE) {}
+
+    /* @brief Selects the error locator core. Both give the same corrections without
+     *        erasures; with erasures CORE_POLY rejects many words CORE_TABLE corrects
+     * @param c - CORE_TABLE (default, faster) or CORE_POLY */
+    void SetDecoderCore(DecoderCore c) {
+        core = c;
+    }
+
+    /* @brief Message block encoding
+     * @param *src - input message buffer      (msg_lenth size)
+     * @param *dst - output buffer for ecc     (ecc_length size at least) */
+     void EncodeBlock(const void* src, void* dst) const {
+        static_assert(msg_length + ecc_length < 256, "codeword must fit in GF(256)");
+
+        LFSREncoder<msg_length, ecc_length>::Encode((const uint8_t*) src, (uint8_t*) dst);
+    }
+
+    /* @brief Message encoding
+     * @param *src - input message buffer      (msg_lenth size)
+     * @param *dst - output buffer             (msg_length + ecc_length size at least) */
+    void Encode(const void* src, void* dst) const {
+        uint8_t* dst_ptr = (uint8_t*) dst;
+
+        // Copying message to the output buffer
+        memcpy(dst_ptr, src, msg_length * sizeof(uint8_t));
+
+        // Calling EncodeBlock to write ecc to out[ut buffer
+        EncodeBlock(src, dst_ptr+msg_length);
+    }
+
+    /* @brief Shortened code encoding: the message is treated as if prefixed by
+     *        msg_length - len zero symbols, which are never sent
+     * @param *src - input message buffer      (len size)
+     * @param len  - message length            (msg_length at most)
+     * @param *dst - output buffer             (len + ecc_length size at least) */
+    void EncodeShortened(const void* src, uint8_t len, void* dst) const {
+        assert(len <= msg_length);
+        uint8_t* dst_ptr = (uint8_t*) dst;
+
+        uint8_t full[msg_length];
+        memset(full, 0, msg_length - len);
+        memcpy(full + msg_length - len, src, len);
+
+        EncodeBlock(full, dst_ptr + len);
+        memmove(dst_ptr, src, len);
+    }
+
+    /* @brief Shortened code decoding, see EncodeShortened
+     * @param *src         - encoded message buffer   (len + ecc_length size)
+     * @param len          - message length           (msg_length at most)
+     * @param *dst         - output buffer            (len size at least)
+     * @param *erase_pos   - known errors positions   (in the shortened codeword)
+     * @param erase_count  - count of known errors
+     * @param *result      - optional decoding summary, positions in the shortened codeword
+     * @return RESULT_SUCCESS if successfull, error code otherwise */
+    int DecodeShortened(const void* src, uint8_t len, void* dst, uint8_t* erase_pos = NULL, size_t erase_count = 0,
+                        DecodeResult* result = NULL) const {
+        if(result != NULL) ClearResult(result, RESULT_BAD_ARGUMENT);
+        if(len > msg_length) return 1;
+        if(erase_count > ecc_length) {
+            if(result != NULL) result->status = RESULT_TOO_MANY_ERRATA;
+            return 1;
+        }
+        const uint8_t pad = msg_length - len;
+
+        uint8_t full[msg_length + ecc_length];
+        memset(full, 0, pad);
+        memcpy(full + pad, src, len + ecc_length);
+
+        uint8_t shifted[ecc_length];
+        for(size_t i = 0; i < erase_count; i++) {
+            if(erase_pos[i] >= len + ecc_length) return 1;
+            shifted[i] = erase_pos[i] + pad;
+        }
+
+        uint8_t out[msg_length];
+        if(Decode(full, out, erase_count ? shifted : NULL, erase_count, result) != 0) return 1;
+
+        // A correction inside the virtual zeros means the decoder picked a wrong codeword
+        for(uint8_t i = 0; i < pad; i++) {
+            if(out[i] != 0) {
+                if(result != NULL) result->status = RESULT_PAD_CORRUPTED;
+                return 1;
             }
         }
+
+        // Positions back to the shortened codeword
+        if(result != NULL) {
+            const uint8_t count = ResultPositions(result);
+            for(uint8_t i = 0; i < count; i++) result->positions[i] -= pad;
+        }
+
+        memcpy(dst, out + pad, len);
+        return 0;
+    }
+
+    /* @brief Message block decoding
+     * @param *src         - encoded message buffer   (msg_length size)
+     * @param *ecc         - ecc buffer               (ecc_length size)
+     * @param *msg_out     - output buffer            (msg_length size at least)
+     * @param *erase_pos   - known errors positions   (below msg_length + ecc_length)
+     * @param erase_count  - count of known errors
+     * @param *result      - optional decoding summary
+     * @return RESULT_SUCCESS if successfull, error code otherwise */
+     int DecodeBlock(const void* src, const void* ecc, void* dst, uint8_t* erase_pos = NULL, size_t erase_count = 0,
+                     DecodeResult* result = NULL) const {
+        assert(msg_length + ecc_length < 256);
+
+        /* Allocation memory on stack, private to this call */
+        Workspace ws;
+
+        return ws.DecodeCodeword((const uint8_t*) src, (const uint8_t*) ecc, (uint8_t*) dst, erase_pos, erase_count,
+                                 core, result);
+    }
+
+    /* @brief Message decoding
+     * @param *src         - encoded message buffer   (msg_length + ecc_length size)
+     * @param *msg_out     - output buffer            (msg_length size at least)
+     * @param *erase_pos   - known errors positions   (below msg_length + ecc_length)
+     * @param erase_count  - count of known errors
+     * @param *result      - optional decoding summary
+     * @return RESULT_SUCCESS if successfull, error code otherwise */
+     int Decode(const void* src, void* dst, uint8_t* erase_pos = NULL, size_t erase_count = 0, DecodeResult* result = NULL) const {
+         const uint8_t *src_ptr = (const uint8_t*) src;
+         const uint8_t *ecc_ptr = src_ptr + msg_length;
+
+         return DecodeBlock(src, ecc_ptr, dst, erase_pos, erase_count, result);
+     }
+
+    /* @brief Decoding of many contiguous codewords in one call
+     * @param *in      - encoded codewords        (n * (msg_length + ecc_length) size)
+     * @param *out     - output messages          (n * msg_length size at least)
+     * @param n        - count of codewords
+     * @param *results - per-codeword results     (n size, may be NULL)
+     * @param threads  - threads on the host, the calling one included, from a pool kept
+     *                    between calls; 1 decodes on the calling thread. At most one
+     *                    thread per core, and RS_BATCH_MIN_PER_THREAD codewords each
+     * @return count of codewords that could not be decoded */
+    size_t DecodeBatch(const uint8_t* in, uint8_t* out, size_t n, DecodeResult* results = NULL, unsigned threads = 1) const {
+        assert(msg_length + ecc_length < 256);
+
+#ifdef RS_BATCH_THREADS
+        const unsigned cores = std::thread::hardware_concurrency();
+        if(cores > 0 && threads > cores) threads = cores;
+        if(threads > n / RS_BATCH_MIN_PER_THREAD) threads = (unsigned)(n / RS_BATCH_MIN_PER_THREAD);
+        if(threads > 1) {
+            /* Slices share this codec, every one decodes with its own workspace */
+            std::vector<size_t> failures(threads, 0);
+            const size_t chunk = (n + threads - 1) / threads;
+
+            const std::function<void(unsigned)> slice = [=, &failures](unsigned t) {
+                const size_t first = t * chunk;
+                if(first >= n) return;
+                const size_t count = (first + chunk > n) ? n - first : chunk;
+                failures[t] = DecodeBatch(in + first * (msg_length + ecc_length),
+                                          out + first * msg_length, count,
+                                          results ? results + first : NULL, 1);
+            };
+
+            /* Another batch on the pool: decode this one here rather than wait */
+            if(BatchPool::Instance().Run(threads, slice)) {
+                size_t failed = 0;
+                for(unsigned t = 0; t < threads; t++) failed += failures[t];
+                return failed;
+            }
+        }
+#else
+        (void) threads;
+#endif
+
+        /* Polynomial memory is set up once for the whole batch */
+        Workspace ws;
+
+        size_t failed = 0;
+        for(size_t i = 0; i < n; i++) {
+            const uint8_t* cw = in + i * (msg_length + ecc_length);
+            DecodeResult* result = results ? results + i : NULL;
+
+            if(ws.DecodeCodeword(cw, cw + msg_length, out + i * msg_length, NULL, 0, core, result) != 0)
+                failed++;
+        }
+        return failed;
+    }
+
+private:
+    DecoderCore core;
+};
+
+/* One entry of a per-frame code rate table, built by ShortenedCode<>::rate() */
+struct CodeRate {
+    uint8_t msg_length;  // longest message
+    uint8_t ecc_length;  // ecc symbols appended to every message
+    void (*encode)(const void* src, uint8_t len, void* dst);
+    int  (*decode)(const void* src, uint8_t len, void* dst, uint8_t* erase_pos, size_t erase_count, DecodeResult* result);
+};
+
+/* Shortened code of one ECC strength behind plain function pointers, so several
+ * strengths can be instantiated up front and picked per frame */
+template <const uint8_t msg_length,
+          const uint8_t ecc_length>
+struct ShortenedCode {
+    static void Encode(const void* src, uint8_t len, void* dst) {
+        codec().EncodeShortened(src, len, dst);
+    }
+
+    static int Decode(const void* src, uint8_t len, void* dst, uint8_t* erase_pos, size_t erase_count,
+                      DecodeResult* result) {
+        return codec().DecodeShortened(src, len, dst, erase_pos, erase_count, result);
+    }
+
+    static constexpr CodeRate rate() {
+        return CodeRate{ msg_length, ecc_length, &Encode, &Decode };
+    }
+
+private:
+    static const ReedSolomon<msg_length, ecc_length>& codec() {
+        static const ReedSolomon<msg_length, ecc_length> rs;
+        return rs;
     }
 };
 
@@ -849,5 +1482,193 @@ private:
 
 #endif // RS_HPP
 
+#ifndef RS_INTERLEAVE_H
+#define RS_INTERLEAVE_H
+
+namespace RS {
+
+/* @brief Block interleaving of depth equal-length slots (codewords): byte j of slot i
+ *        goes to out[j*depth + i], so a burst of b bytes costs every slot at most ceil(b/depth)
+ * @param *slots       - input slots, back to back   (depth * slot_length size)
+ * @param depth        - count of slots
+ * @param slot_length  - length of every slot
+ * @param *out         - interleaved stream          (depth * slot_length size) */
+inline void Interleave(const uint8_t* slots, uint8_t depth, size_t slot_length, uint8_t* out) {
+    for(size_t j = 0; j < slot_length; j++) {
+        for(uint8_t i = 0; i < depth; i++) {
+            *out++ = slots[i * slot_length + j];
+        }
+    }
+}
+
+/* @brief Inverse of Interleave
+ * @param *in          - interleaved stream          (depth * slot_length size)
+ * @param depth        - count of slots
+ * @param slot_length  - length of every slot
+ * @param *slots       - output slots, back to back  (depth * slot_length size) */
+inline void Deinterleave(const uint8_t* in, uint8_t depth, size_t slot_length, uint8_t* slots) {
+    for(size_t j = 0; j < slot_length; j++) {
+        for(uint8_t i = 0; i < depth; i++) {
+            slots[i * slot_length + j] = *in++;
+        }
+    }
+}
+
+}
+
+#endif // RS_INTERLEAVE_H
+
+#ifndef RS_BITSLICE_H
+#define RS_BITSLICE_H
+
+/* 256 lanes when the XOR/AND loops below can be vectorized with AVX2, 64 otherwise */
+#ifndef RS_SLICE_LANES
+#ifdef __AVX2__
+#define RS_SLICE_LANES 256
+#else
+#define RS_SLICE_LANES 64
+#endif
+#endif
+
+namespace RS {
+
+/* @brief Transposes an 8x8 bit matrix held in a word, byte i bit j <-> byte j bit i */
+inline uint64_t transpose8x8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7))  & 0x00AA00AA00AA00AAULL;  x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;  x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;  x ^= t ^ (t << 28);
+    return x;
+}
+
+/* Bit-sliced encoder: `lanes` messages are transposed into bit planes (plane b of a
+ * symbol holds bit b of that symbol of every message, one bit per lane), and the
+ * generator division runs on whole planes with XOR and AND only.
+ * Plane layout: planes[(symbol * 8 + bit) * words + w], lane l is bit l%64 of word l/64. */
+template <const uint8_t msg_length,
+          const uint8_t ecc_length,
+          const size_t  lanes = RS_SLICE_LANES>
+struct BitSlicedEncoder {
+    static_assert(lanes % 64 == 0, "lanes must be a multiple of 64");
+    static const size_t count = lanes;
+    static const size_t words = lanes / 64;
+
+    /* @brief Transposes lanes byte sequences into bit planes
+     * @param *src     - first sequence, lane l starts at src + l * stride
+     * @param stride   - distance between two sequences
+     * @param symbols  - symbols per sequence
+     * @param *planes  - output planes   (symbols * 8 * words size) */
+    static void TransposeIn(const uint8_t* src, size_t stride, size_t symbols, uint64_t* planes) {
+        for(size_t k = 0; k < symbols; k++) {
+            uint64_t* p = planes + k * 8 * words;
+            memset(p, 0, 8 * words * sizeof(uint64_t));
+            for(size_t g = 0; g < lanes / 8; g++) {
+                uint64_t x = 0;
+                for(uint8_t i = 0; i < 8; i++) x |= (uint64_t) src[(g * 8 + i) * stride + k] << (8 * i);
+                x = transpose8x8(x);
+                const size_t w = g / 8, shift = (g % 8) * 8;
+                for(uint8_t b = 0; b < 8; b++) p[b * words + w] |= ((x >> (8 * b)) & 0xff) << shift;
+            }
+        }
+    }
+
+    /* @brief Inverse of TransposeIn
+     * @param *planes  - input planes    (symbols * 8 * words size)
+     * @param symbols  - symbols per sequence
+     * @param *dst     - first sequence, lane l starts at dst + l * stride
+     * @param stride   - distance between two sequences */
+    static void TransposeOut(const uint64_t* planes, size_t symbols, uint8_t* dst, size_t stride) {
+        for(size_t k = 0; k < symbols; k++) {
+            const uint64_t* p = planes + k * 8 * words;
+            for(size_t g = 0; g < lanes / 8; g++) {
+                const size_t w = g / 8, shift = (g % 8) * 8;
+                uint64_t x = 0;
+                for(uint8_t b = 0; b < 8; b++) x |= ((p[b * words + w] >> shift) & 0xff) << (8 * b);
+                x = transpose8x8(x);
+                for(uint8_t i = 0; i < 8; i++) dst[(g * 8 + i) * stride + k] = (uint8_t)(x >> (8 * i));
+            }
+        }
+    }
+
+    /* @brief Computes the ecc planes of lanes messages at once
+     * @param *msg - message planes      (msg_length * 8 * words size)
+     * @param *ecc - output ecc planes   (ecc_length * 8 * words size) */
+    static void EncodeSliced(const uint64_t* msg, uint64_t* ecc) {
+        const Generator<ecc_length>& gen = GeneratorTable<ecc_length>::poly;
+        const size_t sym = 8 * words;
+
+        /* Remainder register as a ring of symbols, reg[head] is the highest degree */
+        uint64_t reg[ecc_length * 8 * words];
+        memset(reg, 0, sizeof(reg));
+        uint8_t head = 0;
+
+        /* mul[k] = 2^k * feedback, so coef * feedback is the XOR of the mul[k] for the set bits of coef */
+        uint64_t mul[8][8 * words];
+
+        for(uint8_t i = 0; i < msg_length; i++) {
+            uint64_t* top = reg + head * sym;
+            for(size_t v = 0; v < sym; v++) {
+                mul[0][v] = msg[i * sym + v] ^ top[v];
+                top[v] = 0;
+            }
+            head = (head + 1 == ecc_length) ? 0 : head + 1;
+
+            /* 2^k * x: bit planes move up by one, plane 7 folds back as 0x1d (bits 0, 2, 3, 4) */
+            for(uint8_t k = 1; k < 8; k++) {
+                const uint64_t* a = mul[k - 1];
+                uint64_t* m = mul[k];
+                for(size_t w = 0; w < words; w++) {
+                    const uint64_t carry = a[7 * words + w];
+                    m[w] = carry;
+                    m[1 * words + w] = a[0 * words + w];
+                    m[2 * words + w] = a[1 * words + w] ^ carry;
+                    m[3 * words + w] = a[2 * words + w] ^ carry;
+                    m[4 * words + w] = a[3 * words + w] ^ carry;
+                    m[5 * words + w] = a[4 * words + w];
+                    m[6 * words + w] = a[5 * words + w];
+                    m[7 * words + w] = a[6 * words + w];
+                }
+            }
+
+            /* reg[j] ^= coef[j+1] * feedback */
+            for(uint8_t j = 0; j < ecc_length; j++) {
+                uint8_t slot = head + j;
+                if(slot >= ecc_length) slot -= ecc_length;
+                uint64_t* r = reg + slot * sym;
+                const uint8_t c = gen.coef[j + 1];
+                for(uint8_t k = 0; k < 8; k++) {
+                    if(!((c >> k) & 1)) continue;
+                    for(size_t v = 0; v < sym; v++) r[v] ^= mul[k][v];
+                }
+            }
+        }
+
+        for(uint8_t j = 0; j < ecc_length; j++) {
+            uint8_t slot = head + j;
+            if(slot >= ecc_length) slot -= ecc_length;
+            memcpy(ecc + j * sym, reg + slot * sym, sym * sizeof(uint64_t));
+        }
+    }
+
+    /* @brief Encodes lanes messages stored back to back
+     * @param *src - input messages      (lanes * msg_length size)
+     * @param *dst - output codewords    (lanes * (msg_length + ecc_length) size) */
+    static void Encode(const uint8_t* src, uint8_t* dst) {
+        const size_t cw_len = msg_length + ecc_length;
+        uint64_t msg[msg_length * 8 * words];
+        uint64_t ecc[ecc_length * 8 * words];
+
+        TransposeIn(src, msg_length, msg_length, msg);
+        EncodeSliced(msg, ecc);
+
+        for(size_t l = 0; l < lanes; l++) memcpy(dst + l * cw_len, src + l * msg_length, msg_length);
+        TransposeOut(ecc, ecc_length, dst + msg_length, cw_len);
+    }
+};
+
+}
+
+#endif // RS_BITSLICE_H
+
 using namespace std;
 
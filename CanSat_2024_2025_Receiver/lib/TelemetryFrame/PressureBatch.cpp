@@ -0,0 +1,77 @@
+#include "PressureBatch.h"
+#include "Varint.h"
+
+size_t PressureBatch::encode(const Sample *samples, size_t count, uint8_t periodMs, uint16_t ageMs,
+                             uint32_t referencePa, uint8_t *out, size_t outSize, size_t &used) {
+    used = 0;
+    if (count == 0 || outSize <= HEADER_SIZE) {
+        return 0;
+    }
+    if (count > MAX_SAMPLES) {
+        count = MAX_SAMPLES;
+    }
+
+    size_t length = HEADER_SIZE;
+    uint32_t previous = referencePa;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t entry[10];
+        uint32_t gap = i > 0 ? samples[i].slot - samples[i - 1].slot - 1 : 0;
+        uint32_t step = zigzagEncode((int32_t)(samples[i].pressure - previous));
+        size_t n = putVarint(entry, step << 1 | (gap > 0));
+        if (gap > 0) {
+            n += putVarint(entry + n, gap - 1);
+        }
+        if (length + n > outSize) {
+            break;
+        }
+        for (size_t b = 0; b < n; b++) {
+            out[length + b] = entry[b];
+        }
+        length += n;
+        previous = samples[i].pressure;
+        used++;
+    }
+    if (used == 0) {
+        return 0;
+    }
+
+    out[0] = (uint8_t)used;
+    out[1] = periodMs;
+    out[2] = (uint8_t)ageMs;
+    out[3] = (uint8_t)(ageMs >> 8);
+    return length;
+}
+
+size_t PressureBatch::decode(const uint8_t *data, size_t length, uint32_t referencePa, Sample *samples,
+                             size_t maxSamples, uint8_t &periodMs, uint16_t &ageMs) {
+    if (length <= HEADER_SIZE || data[0] == 0 || (samples != nullptr && data[0] > maxSamples)) {
+        return 0;
+    }
+    size_t count = data[0];
+    periodMs = data[1];
+    ageMs = (uint16_t)(data[2] | data[3] << 8);
+
+    size_t pos = HEADER_SIZE;
+    uint32_t pressure = referencePa;
+    uint32_t slot = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t value;
+        if (!getVarint(data, length, pos, value)) {
+            return 0;
+        }
+        if (value & 1) {
+            uint32_t gap;
+            if (i == 0 || !getVarint(data, length, pos, gap)) {
+                return 0;
+            }
+            slot += gap + 1;
+        }
+        pressure += (uint32_t)zigzagDecode(value >> 1);
+        if (samples != nullptr) {
+            samples[i].pressure = pressure;
+            samples[i].slot = slot;
+        }
+        slot++;
+    }
+    return pos == length ? count : 0;
+}
@@ -0,0 +1,190 @@
+/* Host round-trip and rejection checks for PressureBatch, not an Arduino sketch.
+ * It sits under examples/ so the firmware build leaves it out.
+ *
+ * Build and run from this directory:
+ *   g++ -O1 -g -fsanitize=address,undefined -I../.. pressure_batch_test.cpp ../../PressureBatch.cpp \
+ *       -o pressure_batch_test && ./pressure_batch_test
+ * Exits non-zero if a check fails. */
+
+#include "PressureBatch.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+typedef PressureBatch::Sample Sample;
+
+static int failures = 0;
+static std::mt19937 rng(1);
+
+static void check(bool ok, const char *name, int round) {
+    if (!ok) {
+        printf("FAIL %s (round %d)\n", name, round);
+        failures++;
+    }
+}
+
+static const size_t BUFFER = PressureBatch::HEADER_SIZE + 10 * PressureBatch::MAX_SAMPLES;
+
+// Decodes out and compares it with the first count samples, their slots counted from the first one
+static bool decodesTo(const uint8_t *out, size_t length, uint32_t referencePa, const Sample *samples, size_t count,
+                      uint8_t periodMs, uint16_t ageMs) {
+    Sample decoded[PressureBatch::MAX_SAMPLES];
+    uint8_t period = 0;
+    uint16_t age = 0;
+    if (PressureBatch::decode(out, length, referencePa, decoded, PressureBatch::MAX_SAMPLES, period, age) != count ||
+        period != periodMs || age != ageMs) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (decoded[i].pressure != samples[i].pressure || decoded[i].slot != samples[i].slot - samples[0].slot) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A steady descent at 25 Hz in every slot: one byte per sample after the header
+static void checkSteadyDescent() {
+    Sample samples[25];
+    for (uint32_t i = 0; i < 25; i++) samples[i] = {89876 + 3 * i, 1000 + i};
+    uint8_t out[BUFFER];
+    size_t used;
+    size_t length = PressureBatch::encode(samples, 25, 40, 960, 89870, out, sizeof(out), used);
+    check(used == 25 && length == PressureBatch::HEADER_SIZE + 25, "one byte per sample", 0);
+    check(decodesTo(out, length, 89870, samples, 25, 40, 960), "steady descent round trip", 0);
+
+    uint8_t period;
+    uint16_t age;
+    check(PressureBatch::decode(out, length, 89870, nullptr, 0, period, age) == 25, "check without samples", 0);
+}
+
+// Missed sample slots, single and long, and pressure steps of either sign and any size
+static void checkSlotGaps() {
+    std::uniform_int_distribution<int> step(-2000, 2000);
+    for (int round = 0; round < 500; round++) {
+        size_t count = 1 + rng() % PressureBatch::MAX_SAMPLES;
+        std::vector<Sample> samples(count);
+        uint32_t slot = rng() % 100000, pressure = 80000 + rng() % 30000;
+        for (size_t i = 0; i < count; i++) {
+            uint32_t r = rng() % 10;
+            slot += i == 0 ? 0 : r < 6 ? 1 : r < 9 ? 2 + rng() % 5 : 10 + rng() % 5000;
+            pressure += step(rng) * (rng() % 20 == 0 ? 1000 : 1);
+            samples[i] = {pressure, slot};
+        }
+        uint32_t reference = samples[0].pressure + step(rng);
+        uint8_t period = (uint8_t)(1 + rng() % 255);
+        uint16_t age = (uint16_t)rng();
+
+        uint8_t out[BUFFER];
+        size_t used;
+        size_t length = PressureBatch::encode(samples.data(), count, period, age, reference, out, sizeof(out), used);
+        check(used == count, "whole batch fits", round);
+        check(decodesTo(out, length, reference, samples.data(), count, period, age), "slot gap round trip", round);
+    }
+}
+
+// Out of room the batch keeps the oldest samples that fit, and stays a valid batch of them
+static void checkTruncation() {
+    Sample samples[PressureBatch::MAX_SAMPLES + 10];
+    for (uint32_t i = 0; i < PressureBatch::MAX_SAMPLES + 10; i++) samples[i] = {95000 + 700 * (i % 7), 3 * i};
+    uint8_t out[BUFFER];
+    size_t used;
+
+    for (size_t room = PressureBatch::HEADER_SIZE + 1; room < 80; room++) {
+        size_t length = PressureBatch::encode(samples, 40, 40, 0, 95000, out, room, used);
+        check(length <= room && (used == 0) == (length == 0), "encode stays inside outSize", (int)room);
+        check(used == 0 || decodesTo(out, length, 95000, samples, used, 40, 0), "truncated batch round trip", (int)room);
+    }
+
+    check(PressureBatch::encode(samples, 10, 40, 0, 95000, out, PressureBatch::HEADER_SIZE, used) == 0 && used == 0,
+          "no room past the header", 0);
+    check(PressureBatch::encode(samples, 0, 40, 0, 95000, out, sizeof(out), used) == 0 && used == 0, "no samples", 0);
+
+    size_t length = PressureBatch::encode(samples, PressureBatch::MAX_SAMPLES + 10, 40, 0, 95000, out, sizeof(out), used);
+    check(used == PressureBatch::MAX_SAMPLES && decodesTo(out, length, 95000, samples, used, 40, 0),
+          "count capped at MAX_SAMPLES", 0);
+}
+
+// The frame of the batch had a NaN pressure reading, sent as UINT32_MAX: the steps wrap around it
+static void checkNanReference() {
+    Sample samples[3] = {{101325, 0}, {101320, 1}, {101318, 3}};
+    uint8_t out[BUFFER];
+    size_t used;
+    size_t length = PressureBatch::encode(samples, 3, 40, 120, UINT32_MAX, out, sizeof(out), used);
+    check(used == 3 && decodesTo(out, length, UINT32_MAX, samples, 3, 40, 120), "NaN reference round trip", 0);
+}
+
+// Batches that do not fill their data exactly or contradict themselves
+static void checkRejection() {
+    Sample samples[6] = {{90000, 0}, {90004, 1}, {89990, 4}, {89985, 5}, {89980, 400}, {89979, 401}};
+    uint8_t out[BUFFER + 1];
+    size_t used;
+    size_t length = PressureBatch::encode(samples, 6, 40, 300, 90002, out, sizeof(out), used);
+    check(decodesTo(out, length, 90002, samples, 6, 40, 300), "valid batch", 0);
+
+    Sample decoded[PressureBatch::MAX_SAMPLES];
+    uint8_t period;
+    uint16_t age;
+    for (size_t cut = 0; cut < length; cut++) {
+        check(PressureBatch::decode(out, cut, 90002, decoded, PressureBatch::MAX_SAMPLES, period, age) == 0,
+              "batch cut short", (int)cut);
+    }
+
+    out[length] = 0;
+    check(PressureBatch::decode(out, length + 1, 90002, decoded, PressureBatch::MAX_SAMPLES, period, age) == 0,
+          "byte past the last sample", 0);
+    check(PressureBatch::decode(out, length, 90002, decoded, 5, period, age) == 0, "more samples than maxSamples", 0);
+
+    uint8_t bad[BUFFER];
+    memcpy(bad, out, length);
+    bad[0] = 0;
+    check(PressureBatch::decode(bad, length, 90002, decoded, PressureBatch::MAX_SAMPLES, period, age) == 0,
+          "zero sample count", 0);
+    bad[0] = 7;
+    check(PressureBatch::decode(bad, length, 90002, decoded, PressureBatch::MAX_SAMPLES, period, age) == 0,
+          "count above the samples sent", 0);
+    bad[0] = 5;
+    check(PressureBatch::decode(bad, length, 90002, decoded, PressureBatch::MAX_SAMPLES, period, age) == 0,
+          "count below the samples sent", 0);
+
+    // One sample with a step of 0 and a single missed slot before it: the first sample has no slot
+    // before it to have missed
+    const uint8_t gapFirst[] = {1, 40, 0, 0, 0x01, 0x00};
+    check(PressureBatch::decode(gapFirst, sizeof(gapFirst), 90002, decoded, PressureBatch::MAX_SAMPLES, period, age) == 0,
+          "slot gap before the first sample", 0);
+}
+
+// Random bytes never read past their length, and what decodes also checks without samples
+static void checkRandomBatches() {
+    int accepted = 0;
+    for (int round = 0; round < 100000; round++) {
+        size_t length = rng() % 64;
+        std::vector<uint8_t> data(length);
+        for (uint8_t &b : data) b = (uint8_t)rng();
+        Sample decoded[PressureBatch::MAX_SAMPLES];
+        uint8_t period;
+        uint16_t age;
+        size_t count = PressureBatch::decode(data.data(), length, 100000, decoded, PressureBatch::MAX_SAMPLES, period, age);
+        check(count == PressureBatch::decode(data.data(), length, 100000, nullptr, 0, period, age),
+              "check agrees with decode", round);
+        accepted += count > 0 ? 1 : 0;
+    }
+    printf("%d of 100000 random byte strings parse as a batch\n", accepted);
+}
+
+int main() {
+    checkSteadyDescent();
+    checkSlotGaps();
+    checkTruncation();
+    checkNanReference();
+    checkRejection();
+    checkRandomBatches();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All PressureBatch checks passed\n");
+    return 0;
+}
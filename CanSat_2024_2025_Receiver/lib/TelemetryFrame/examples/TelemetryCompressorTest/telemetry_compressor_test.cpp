@@ -0,0 +1,200 @@
+/* Host round-trip and rejection checks for TelemetryCompressor, not an Arduino sketch.
+ * It sits under examples/ so the firmware build leaves it out.
+ *
+ * Build and run from this directory:
+ *   g++ -O1 -g -fsanitize=address,undefined -I../.. telemetry_compressor_test.cpp ../../TelemetryFrame.cpp \
+ *       ../../TelemetryCompressor.cpp -o telemetry_compressor_test && ./telemetry_compressor_test
+ * Exits non-zero if a check fails. */
+
+#include "TelemetryCompressor.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+static int failures = 0;
+static std::mt19937 rng(1);
+
+static void check(bool ok, const char *name, int round) {
+    if (!ok) {
+        printf("FAIL %s (round %d)\n", name, round);
+        failures++;
+    }
+}
+
+// A descent under a parachute, one sample per message, starting at the given message number
+static Telemetry sampleAt(uint16_t message, int step) {
+    std::uniform_real_distribution<double> jitter(-1.0, 1.0);
+    Telemetry sample;
+    sample.messageNumber = message;
+    sample.latitude = 50.0875 + step * 2e-6 + jitter(rng) * 1e-6;
+    sample.longitude = 14.4213 - step * 3e-6 + jitter(rng) * 1e-6;
+    sample.day = 14;
+    sample.month = 6;
+    sample.year = 2025;
+    sample.hour = 10;
+    sample.minute = (step / 60) % 60;
+    sample.second = step % 60;
+    sample.speedKPH = 28.0 + jitter(rng);
+    sample.course = 90.0 + 5 * jitter(rng);
+    sample.altitude = 1000.0 - step * 8.0 + jitter(rng);
+    sample.satellites = 9 + (step / 50) % 3;
+    sample.pressure = 898.76 + step * 0.09 + 0.02 * jitter(rng);
+    sample.temperature = 21.5 - step * 0.01;
+    return sample;
+}
+
+static void frameOf(const Telemetry &sample, uint8_t *frame) {
+    TelemetryFrame::serialize(sample, frame, TelemetryFrame::SIZE);
+}
+
+// A key frame followed by deltas: every frame comes back bit-exact, the deltas are shorter than
+// a key frame and the key frames come every keyInterval frames
+static void checkRoundTrip() {
+    const uint8_t interval = TelemetryCompressor::DEFAULT_KEY_INTERVAL;
+    TelemetryCompressor compressor(interval);
+    TelemetryDecompressor decompressor;
+    size_t keyFrames = 0, deltaBytes = 0, deltas = 0;
+
+    for (int step = 0; step < 400; step++) {
+        uint8_t frame[TelemetryFrame::SIZE], packed[TelemetryFrame::SIZE], restored[TelemetryFrame::SIZE];
+        frameOf(sampleAt((uint16_t)step, step), frame);
+        size_t length = compressor.compress(frame, packed);
+
+        bool key = length == TelemetryFrame::SIZE;
+        check(key == (step % interval == 0), "key frame every keyInterval frames", step);
+        check(key || packed[0] == TelemetryCompressor::DELTA_VERSION, "delta version byte", step);
+        check(TelemetryDecompressor::recognized(packed, length), "recognized", step);
+        check(TelemetryDecompressor::frameLength(packed, length) == length, "frame length", step);
+        check(decompressor.decompress(packed, length, restored) && memcmp(restored, frame, TelemetryFrame::SIZE) == 0,
+              "key and delta round trip", step);
+        keyFrames += key ? 1 : 0;
+        if (!key) {
+            deltaBytes += length;
+            deltas++;
+        }
+    }
+    printf("400 frames: %zu key frames of %zu bytes, %zu deltas of %.1f bytes on average\n", keyFrames,
+           TelemetryFrame::SIZE, deltas, (double)deltaBytes / deltas);
+}
+
+// Words that wrap or flip sign between the key frame and the delta: the message counter past 65535,
+// altitude below zero, a NaN reading sent as the lowest or highest value of its field
+static void checkWrappingWords() {
+    TelemetryCompressor compressor(4);
+    TelemetryDecompressor decompressor;
+    Telemetry samples[4] = {sampleAt(65534, 0), sampleAt(65535, 1), sampleAt(0, 2), sampleAt(1, 3)};
+    samples[0].altitude = 3.0;
+    samples[1].altitude = -2.5;
+    samples[2].temperature = NAN;
+    samples[3].pressure = NAN;
+    samples[3].latitude = NAN;
+
+    for (int i = 0; i < 4; i++) {
+        uint8_t frame[TelemetryFrame::SIZE], packed[TelemetryFrame::SIZE], restored[TelemetryFrame::SIZE];
+        frameOf(samples[i], frame);
+        size_t length = compressor.compress(frame, packed);
+        check(i == 0 || length < TelemetryFrame::SIZE, "wrapped word still a delta", i);
+        check(decompressor.decompress(packed, length, restored) && memcmp(restored, frame, TelemetryFrame::SIZE) == 0,
+              "wrapped word round trip", i);
+    }
+}
+
+// A frame that shares nothing with its key frame is sent whole, and forceKeyFrame sends the next one whole
+static void checkKeyFallback() {
+    TelemetryCompressor compressor;
+    uint8_t frame[TelemetryFrame::SIZE], packed[TelemetryFrame::SIZE];
+    frameOf(sampleAt(1, 0), frame);
+    compressor.compress(frame, packed);
+    frameOf(sampleAt(2, 1), frame);
+    check(compressor.compress(frame, packed) < TelemetryFrame::SIZE, "delta after the key frame", 0);
+    compressor.forceKeyFrame();
+    check(compressor.compress(frame, packed) == TelemetryFrame::SIZE, "forceKeyFrame", 0);
+
+    uint8_t noise[TelemetryFrame::SIZE];
+    for (size_t i = 0; i < sizeof(noise); i++) noise[i] = (uint8_t)rng();
+    noise[0] = TelemetryFrame::VERSION;
+    check(compressor.compress(noise, packed) == TelemetryFrame::SIZE && memcmp(packed, noise, sizeof(noise)) == 0,
+          "unrelated frame sent as a key frame", 0);
+}
+
+// Deltas without their key frame are refused until the next key frame arrives
+static void checkLostKeyFrame() {
+    TelemetryCompressor compressor(4);
+    TelemetryDecompressor decompressor;
+    uint8_t restored[TelemetryFrame::SIZE];
+    check(!decompressor.synchronized(), "fresh decompressor unsynchronized", 0);
+
+    for (int step = 0; step < 12; step++) {
+        uint8_t frame[TelemetryFrame::SIZE], packed[TelemetryFrame::SIZE];
+        frameOf(sampleAt((uint16_t)(100 + step), step), frame);
+        size_t length = compressor.compress(frame, packed);
+
+        // The key frames of steps 0 and 8 are lost: the deltas before step 4 have no key frame, and
+        // the ones after step 8 must not be restored against the key frame of step 4
+        if (step == 0) continue;
+        if (step == 4) {
+            decompressor.decompress(packed, length, restored);
+            continue;
+        }
+        if (step == 8) continue;
+
+        bool ok = decompressor.decompress(packed, length, restored);
+        check(ok == (step > 4 && step < 8), "deltas only against their own key frame", step);
+        check(!ok || memcmp(restored, frame, TelemetryFrame::SIZE) == 0, "restored frame", step);
+    }
+}
+
+// Frames of another version, cut short or with bytes past their last varint
+static void checkRejection() {
+    TelemetryCompressor compressor;
+    TelemetryDecompressor decompressor;
+    uint8_t frame[TelemetryFrame::SIZE], key[TelemetryFrame::SIZE], packed[TelemetryFrame::SIZE + 4];
+    uint8_t restored[TelemetryFrame::SIZE];
+    frameOf(sampleAt(7, 0), key);
+    compressor.compress(key, packed);
+    check(decompressor.decompress(packed, TelemetryFrame::SIZE, restored), "key frame", 0);
+
+    frameOf(sampleAt(8, 1), frame);
+    size_t length = compressor.compress(frame, packed);
+    check(length < TelemetryFrame::SIZE, "delta frame", 0);
+
+    uint8_t bad[TelemetryFrame::SIZE + 4];
+    memcpy(bad, key, TelemetryFrame::SIZE);
+    bad[0] = TelemetryFrame::VERSION + 1;
+    check(!decompressor.decompress(bad, TelemetryFrame::SIZE, restored), "key frame of another version", 0);
+    check(!decompressor.decompress(key, TelemetryFrame::SIZE - 1, restored), "key frame cut short", 0);
+
+    memcpy(bad, packed, length);
+    bad[0] = TelemetryCompressor::DELTA_VERSION ^ 0x01;
+    check(!decompressor.decompress(bad, length, restored), "delta of another version", 0);
+    check(!decompressor.decompress(packed, length - 1, restored), "delta cut short", 0);
+
+    memcpy(bad, packed, length);
+    bad[length] = 0;
+    check(!decompressor.decompress(bad, length + 1, restored), "byte past the last varint", 0);
+    check(TelemetryDecompressor::frameLength(bad, length + 1) == length, "frame length before a trailer", 0);
+
+    memcpy(bad, packed, length);
+    bad[1] ^= 0xFF;
+    check(!decompressor.decompress(bad, length, restored), "delta of another key frame", 0);
+
+    // The rejected frames left the key frame alone
+    check(decompressor.decompress(packed, length, restored) && memcmp(restored, frame, TelemetryFrame::SIZE) == 0,
+          "delta after the rejected frames", 0);
+}
+
+int main() {
+    checkRoundTrip();
+    checkWrappingWords();
+    checkKeyFallback();
+    checkLostKeyFrame();
+    checkRejection();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All TelemetryCompressor checks passed\n");
+    return 0;
+}
@@ -0,0 +1,254 @@
+#include "TurboWindowDecoder.h"
+#include <algorithm>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Saturating 16-bit arithmetic, the scalar twins of _mm256_adds_epi16 and _mm256_subs_epi16
+static int16_t adds(int16_t a, int16_t b) {
+    int32_t s = (int32_t)a + b;
+    return s > INT16_MAX ? INT16_MAX : (s < INT16_MIN ? INT16_MIN : s);
+}
+
+static int16_t subs(int16_t a, int16_t b) {
+    int32_t s = (int32_t)a - b;
+    return s > INT16_MAX ? INT16_MAX : (s < INT16_MIN ? INT16_MIN : s);
+}
+
+// Extrinsic scaling by 3/4 against the max-log approximation, then saturation
+static int16_t scaleExtrinsic(int16_t d) {
+    d = subs(d, d >> 2);
+    return std::min<int16_t>(std::max<int16_t>(d, -TurboCodec::LLR_LIMIT), TurboCodec::LLR_LIMIT);
+}
+
+TurboWindowDecoder::TurboWindowDecoder(TurboCodec &codec) : codec(codec), window(0) {}
+
+bool TurboWindowDecoder::simdAvailable() {
+#ifdef __AVX2__
+    return true;
+#else
+    return false;
+#endif
+}
+
+void TurboWindowDecoder::constituent(const ConvolutionalCode &code, const int16_t *sys, const int16_t *par,
+                                     const int16_t *apriori, int16_t *extrinsic, size_t length, bool simd) {
+    const uint32_t S = ConvolutionalCode::STATES;
+    window = (length + LANES - 1) / LANES;
+    const size_t steps = window + 2 * WARMUP;
+
+    // Gather the branch inputs step-major, lane w holds the steps from w * window - WARMUP on.
+    // Steps outside the trellis are known zero inputs, the encoder rests in state 0 before and after it
+    branch.resize(steps * 2 * LANES);
+    for (size_t j = 0; j < steps; j++) {
+        int16_t *lu = &branch[j * 2 * LANES];
+        for (size_t w = 0; w < LANES; w++) {
+            size_t k = w * window + j - WARMUP;
+            bool inside = w * window + j >= WARMUP && k < length;
+            lu[w] = inside ? adds(sys[k], apriori[k]) : -TurboCodec::LLR_LIMIT;
+            lu[LANES + w] = inside ? par[k] : 0;
+        }
+    }
+
+    uint8_t out[S][2];
+    for (uint32_t s = 0; s < S; s++) {
+        for (uint8_t u = 0; u < 2; u++) {
+            out[s][u] = code.parity(s, u);
+        }
+    }
+
+    alpha.resize((WARMUP + window + 1) * S * LANES);
+    ext.resize(window * LANES);
+#ifdef __AVX2__
+    if (simd) {
+        mapAvx2(out);
+    } else {
+        mapScalar(out);
+    }
+#else
+    (void)simd;
+    mapScalar(out);
+#endif
+
+    for (size_t w = 0; w < LANES; w++) {
+        for (size_t i = 0; i < window && w * window + i < length; i++) {
+            extrinsic[w * window + i] = ext[i * LANES + w];
+        }
+    }
+}
+
+void TurboWindowDecoder::mapScalar(const uint8_t (*out)[2]) {
+    const uint32_t S = ConvolutionalCode::STATES;
+    const size_t steps = window + 2 * WARMUP;
+
+    // Forward metrics from equally likely states at the start of the warm-up
+    std::fill(alpha.begin(), alpha.begin() + S * LANES, 0);
+    for (size_t j = 0; j < WARMUP + window; j++) {
+        const int16_t *lu = &branch[j * 2 * LANES];
+        const int16_t *a = &alpha[j * S * LANES];
+        int16_t *an = &alpha[(j + 1) * S * LANES];
+        for (size_t w = 0; w < LANES; w++) {
+            // Branch metric by input bit (bit 0) and parity bit (bit 1)
+            int16_t g[4] = {0, lu[w], lu[LANES + w], adds(lu[w], lu[LANES + w])};
+            int16_t best = INT16_MIN;
+            for (uint32_t t = 0; t < S; t++) {
+                uint8_t u = t & 1;
+                uint32_t s0 = t >> 1, s1 = s0 + S / 2;
+                int16_t m = std::max(adds(a[s0 * LANES + w], g[u | out[s0][u] << 1]),
+                                     adds(a[s1 * LANES + w], g[u | out[s1][u] << 1]));
+                an[t * LANES + w] = m;
+                best = std::max(best, m);
+            }
+            for (uint32_t t = 0; t < S; t++) {
+                an[t * LANES + w] = subs(an[t * LANES + w], best);
+            }
+        }
+    }
+
+    // Backward metrics from equally likely states at the end of the warm-up
+    int16_t beta[S][LANES], betaPrev[S][LANES];
+    std::fill(&beta[0][0], &beta[0][0] + S * LANES, 0);
+    for (size_t j = steps; j-- > WARMUP;) {
+        const int16_t *lu = &branch[j * 2 * LANES];
+        // alpha ends with the window, the trailing warm-up steps only carry beta
+        bool inWindow = j < WARMUP + window;
+        const int16_t *a = inWindow ? &alpha[j * S * LANES] : nullptr;
+        for (size_t w = 0; w < LANES; w++) {
+            int16_t g[4] = {0, lu[w], lu[LANES + w], adds(lu[w], lu[LANES + w])};
+            int16_t best = INT16_MIN, best0 = INT16_MIN, best1 = INT16_MIN;
+            for (uint32_t s = 0; s < S; s++) {
+                int16_t b0 = adds(g[out[s][0] << 1], beta[ConvolutionalCode::nextState(s, 0)][w]);
+                int16_t b1 = adds(g[1 | out[s][1] << 1], beta[ConvolutionalCode::nextState(s, 1)][w]);
+                betaPrev[s][w] = std::max(b0, b1);
+                best = std::max(best, betaPrev[s][w]);
+                if (inWindow) {
+                    best0 = std::max(best0, adds(a[s * LANES + w], b0));
+                    best1 = std::max(best1, adds(a[s * LANES + w], b1));
+                }
+            }
+            if (inWindow) {
+                ext[(j - WARMUP) * LANES + w] = scaleExtrinsic(subs(subs(best1, best0), lu[w]));
+            }
+            for (uint32_t s = 0; s < S; s++) {
+                beta[s][w] = subs(betaPrev[s][w], best);
+            }
+        }
+    }
+}
+
+#ifdef __AVX2__
+void TurboWindowDecoder::mapAvx2(const uint8_t (*out)[2]) {
+    const uint32_t S = ConvolutionalCode::STATES;
+    const size_t steps = window + 2 * WARMUP;
+    static_assert(LANES == 16, "one __m256i holds the 16 lanes of a state");
+
+    const __m256i limit = _mm256_set1_epi16(TurboCodec::LLR_LIMIT);
+    const __m256i negLimit = _mm256_set1_epi16(-TurboCodec::LLR_LIMIT);
+
+    __m256i *A = (__m256i *)alpha.data();
+    for (uint32_t s = 0; s < S; s++) {
+        _mm256_storeu_si256(&A[s], _mm256_setzero_si256());
+    }
+    for (size_t j = 0; j < WARMUP + window; j++) {
+        __m256i lu = _mm256_loadu_si256((const __m256i *)&branch[j * 2 * LANES]);
+        __m256i par = _mm256_loadu_si256((const __m256i *)&branch[j * 2 * LANES + LANES]);
+        __m256i g[4] = {_mm256_setzero_si256(), lu, par, _mm256_adds_epi16(lu, par)};
+        const __m256i *a = &A[j * S];
+        __m256i an[S];
+        __m256i best = _mm256_set1_epi16(INT16_MIN);
+        for (uint32_t t = 0; t < S; t++) {
+            uint8_t u = t & 1;
+            uint32_t s0 = t >> 1, s1 = s0 + S / 2;
+            an[t] = _mm256_max_epi16(_mm256_adds_epi16(_mm256_loadu_si256(&a[s0]), g[u | out[s0][u] << 1]),
+                                     _mm256_adds_epi16(_mm256_loadu_si256(&a[s1]), g[u | out[s1][u] << 1]));
+            best = _mm256_max_epi16(best, an[t]);
+        }
+        for (uint32_t t = 0; t < S; t++) {
+            _mm256_storeu_si256(&A[(j + 1) * S + t], _mm256_subs_epi16(an[t], best));
+        }
+    }
+
+    __m256i beta[S], betaPrev[S];
+    for (uint32_t s = 0; s < S; s++) {
+        beta[s] = _mm256_setzero_si256();
+    }
+    for (size_t j = steps; j-- > WARMUP;) {
+        __m256i lu = _mm256_loadu_si256((const __m256i *)&branch[j * 2 * LANES]);
+        __m256i par = _mm256_loadu_si256((const __m256i *)&branch[j * 2 * LANES + LANES]);
+        __m256i g[4] = {_mm256_setzero_si256(), lu, par, _mm256_adds_epi16(lu, par)};
+        bool inWindow = j < WARMUP + window;
+        const __m256i *a = inWindow ? &A[j * S] : nullptr;
+        __m256i best = _mm256_set1_epi16(INT16_MIN);
+        __m256i best0 = best, best1 = best;
+        for (uint32_t s = 0; s < S; s++) {
+            __m256i b0 = _mm256_adds_epi16(g[out[s][0] << 1], beta[ConvolutionalCode::nextState(s, 0)]);
+            __m256i b1 = _mm256_adds_epi16(g[1 | out[s][1] << 1], beta[ConvolutionalCode::nextState(s, 1)]);
+            betaPrev[s] = _mm256_max_epi16(b0, b1);
+            best = _mm256_max_epi16(best, betaPrev[s]);
+            if (inWindow) {
+                __m256i as = _mm256_loadu_si256(&a[s]);
+                best0 = _mm256_max_epi16(best0, _mm256_adds_epi16(as, b0));
+                best1 = _mm256_max_epi16(best1, _mm256_adds_epi16(as, b1));
+            }
+        }
+        if (inWindow) {
+            __m256i d = _mm256_subs_epi16(_mm256_subs_epi16(best1, best0), lu);
+            d = _mm256_subs_epi16(d, _mm256_srai_epi16(d, 2));
+            d = _mm256_min_epi16(_mm256_max_epi16(d, negLimit), limit);
+            _mm256_storeu_si256((__m256i *)&ext[(j - WARMUP) * LANES], d);
+        }
+        for (uint32_t s = 0; s < S; s++) {
+            beta[s] = _mm256_subs_epi16(betaPrev[s], best);
+        }
+    }
+}
+#endif
+
+bool TurboWindowDecoder::decode(const int16_t *llr, size_t dataBits, uint8_t *output,
+                                TurboCodec::Puncturing rate, int iterations, bool simd) {
+    std::vector<uint16_t> uncached;
+    const uint16_t *interleaver = codec.interleaverFor(dataBits, uncached);
+
+    // Both trellises run on past the data through the tail bits
+    const size_t length = dataBits + ConvolutionalCode::TAIL_BITS;
+    std::vector<int16_t> sys(length), par1(length), par2(length);
+    TurboCodec::depuncture(llr, dataBits, rate, sys.data(), par1.data(), par2.data());
+
+    // The second decoder sees the systematic bits in interleaved order
+    std::vector<int16_t> sysPerm(sys);
+    for (size_t i = 0; i < dataBits; ++i) {
+        sysPerm[i] = sys[interleaver[i]];
+    }
+
+    // Same early stop as TurboCodec::decodeSoft: channel decisions first, then one a-posteriori
+    // decision per half-iteration until the CRC matches
+    for (size_t i = 0; i < dataBits; ++i) {
+        output[i] = sys[i] > 0 ? 1 : 0;
+    }
+    bool passed = TurboCodec::crcMatches(output, dataBits);
+
+    std::vector<int16_t> apriori1(length, 0), extrinsic1(length), apriori2(length, 0), extrinsic2(length);
+    for (int it = 0; it < iterations && !passed; ++it) {
+        constituent(codec.encoder1, sys.data(), par1.data(), apriori1.data(), extrinsic1.data(), length, simd);
+        for (size_t i = 0; i < dataBits; ++i) {
+            output[i] = ((int32_t)sys[i] + extrinsic1[i] + apriori1[i]) > 0 ? 1 : 0;
+        }
+        if ((passed = TurboCodec::crcMatches(output, dataBits))) {
+            break;
+        }
+
+        for (size_t i = 0; i < dataBits; ++i) {
+            apriori2[i] = extrinsic1[interleaver[i]];
+        }
+        constituent(codec.encoder2, sysPerm.data(), par2.data(), apriori2.data(), extrinsic2.data(), length, simd);
+        for (size_t i = 0; i < dataBits; ++i) {
+            output[interleaver[i]] = ((int32_t)sysPerm[i] + apriori2[i] + extrinsic2[i]) > 0 ? 1 : 0;
+        }
+        passed = TurboCodec::crcMatches(output, dataBits);
+
+        for (size_t i = 0; i < dataBits; ++i) {
+            apriori1[interleaver[i]] = extrinsic2[i];
+        }
+    }
+    return passed;
+}
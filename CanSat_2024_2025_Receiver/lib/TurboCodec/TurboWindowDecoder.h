@@ -0,0 +1,42 @@
+#ifndef TURBO_WINDOW_DECODER_H
+#define TURBO_WINDOW_DECODER_H
+
+#include "TurboCodec.h"
+
+// Windowed max-log-MAP Turbo decoder for the ground station.
+// Every trellis is cut into LANES windows that are decoded side by side, one per 16-bit lane,
+// each window warming up its metrics over WARMUP steps of its neighbours. With AVX2 all lanes of
+// one state sit in one register; without it the same saturating arithmetic runs lane by lane,
+// so both paths give bit-exact results. Not thread safe: use one decoder, and one TurboCodec, per thread
+class TurboWindowDecoder {
+public:
+    static constexpr size_t LANES = 16;  // Windows per trellis, one per int16 lane
+    static constexpr size_t WARMUP = 16; // Trellis steps run before and after every window
+
+    TurboWindowDecoder(TurboCodec &codec); // Uses the constituent codes and interleavers of codec
+
+    // Turbo decoding of channel LLRs, same arguments, CRC early stop and result as TurboCodec::decodeSoft.
+    // simd selects the AVX2 path if it was compiled in, false always runs the scalar reference
+    bool decode(const int16_t *llr, size_t dataBits, uint8_t *output,
+                TurboCodec::Puncturing rate = TurboCodec::RATE_1_3,
+                int iterations = TurboCodec::DEFAULT_ITERATIONS, bool simd = true);
+
+    static bool simdAvailable(); // Checks if the AVX2 path was compiled in
+
+private:
+    // Max-log-MAP pass over one constituent code, all windows at once
+    void constituent(const ConvolutionalCode &code, const int16_t *sys, const int16_t *par,
+                     const int16_t *apriori, int16_t *extrinsic, size_t length, bool simd);
+
+    // Forward and backward recursions over the [step][lane] branch inputs, scalar reference and AVX2
+    void mapScalar(const uint8_t (*out)[2]);
+    void mapAvx2(const uint8_t (*out)[2]);
+
+    TurboCodec &codec;
+    size_t window;                // Trellis steps per window
+    std::vector<int16_t> branch;  // Per step: LANES systematic plus a-priori LLRs, then LANES parity LLRs
+    std::vector<int16_t> alpha;   // Forward metrics, [step][state][lane]
+    std::vector<int16_t> ext;     // Extrinsic LLRs of the window steps, [step][lane]
+};
+
+#endif // TURBO_WINDOW_DECODER_H
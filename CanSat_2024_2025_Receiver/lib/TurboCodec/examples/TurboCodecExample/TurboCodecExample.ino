@@ -0,0 +1,29 @@
+#include <Arduino.h>
+#include <TurboCodec.h>
+
+TurboCodec codec; // Global, the codec tables are too large for the loop task stack
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    std::string inputMessage = "Hello ESP32!";
+    Serial.println("Original Message: " + String(inputMessage.c_str()));
+
+    std::string encodedMessage = codec.encode(inputMessage);
+    Serial.println("Turbo Encoded Message: " + String(encodedMessage.c_str()));
+
+    // Flip one coded bit and decode it back
+    std::vector<uint8_t> bits(encodedMessage.size());
+    for (size_t i = 0; i < bits.size(); i++) {
+        bits[i] = encodedMessage[i] == '1';
+    }
+    bits[10] ^= 1;
+
+    std::string decodedMessage = codec.decode(bits);
+    Serial.println("Turbo Decoded Message: " + String(decodedMessage.c_str()));
+}
+
+void loop() {
+    // Loop left empty
+}
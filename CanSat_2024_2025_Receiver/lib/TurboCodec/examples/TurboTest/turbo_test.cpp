@@ -0,0 +1,198 @@
+/* Host round-trip and error-rate checks for TurboCodec, not an Arduino sketch.
+ * It sits under examples/ so the firmware build leaves it out.
+ *
+ * Build and run from this directory:
+ *   g++ -O1 -g -fsanitize=address,undefined -I../.. turbo_test.cpp ../../TurboCodec.cpp -o turbo_test && ./turbo_test
+ * Exits non-zero if a check fails. The single-bit sweep and the BER/FER table print how many frames the
+ * decoder leaves uncorrected, the limits below are the measured counts plus a small margin so a weaker
+ * decoder fails the run. Only systematic bit errors are ever left: a parity bit error keeps the CRC of
+ * the channel decisions. The code is weak, ConvolutionalCode::parity sets a bit per overlapping generator
+ * shift rather than XOR-ing the taps, so many branches share their parity and a single systematic error
+ * often has two equally close codewords. Changing it changes the frames on air, this test only keeps the
+ * weakness measured. */
+
+#include "TurboCodec.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+static const TurboCodec::Puncturing RATES[] = {TurboCodec::RATE_1_3, TurboCodec::RATE_1_2, TurboCodec::RATE_2_3};
+static const char *RATE_NAMES[] = {"1/3", "1/2", "2/3"};
+
+// Most single-bit errors of a 96-byte frame left uncorrected, per rate
+static const int SWEEP_LIMIT[] = {160, 440, 720};
+
+// Bit error rates of the FER table and the most frame errors allowed out of FER_FRAMES, per rate
+static const double FER_BER[] = {0.0005, 0.001, 0.002};
+static const int FER_FRAMES = 200;
+static const int FER_LIMIT[][3] = {{18, 32, 56}, {45, 75, 120}, {64, 112, 166}};
+
+static int failures = 0;
+static std::mt19937 rng(1);
+
+static void check(bool ok, const char *name, int round) {
+    if (!ok) {
+        printf("FAIL %s (round %d)\n", name, round);
+        failures++;
+    }
+}
+
+static std::string randomMessage(size_t length) {
+    std::string message(length, '\0');
+    for (size_t i = 0; i < length; i++) message[i] = (char)(rng() & 0xFF);
+    return message;
+}
+
+// Packed encoding unpacked to one bit per byte, the input of decode
+static std::vector<uint8_t> encodeBits(TurboCodec &codec, const std::string &message, TurboCodec::Puncturing rate) {
+    std::vector<uint8_t> packed(TurboCodec::encodedBytes(message.size()));
+    size_t bits = codec.encode((const uint8_t *)message.data(), message.size(), packed.data(), packed.size(), rate);
+    std::vector<uint8_t> out(bits);
+    for (size_t i = 0; i < bits; i++) out[i] = (packed[i / 8] >> (7 - i % 8)) & 1;
+    return out;
+}
+
+// Both encoders agree, every length and rate decodes back without errors
+static void checkRoundTrip(TurboCodec &codec) {
+    static const size_t LENGTHS[] = {1, 2, 17, 62, 96, TurboCodec::MAX_INPUT_BYTES};
+    int round = 0;
+    for (size_t r = 0; r < TurboCodec::PUNCTURING_COUNT; r++) {
+        for (size_t length : LENGTHS) {
+            std::string message = randomMessage(length);
+            std::vector<uint8_t> bits = encodeBits(codec, message, RATES[r]);
+            std::string reference = codec.encode(message, RATES[r]);
+
+            bool same = bits.size() == reference.size() && bits.size() == TurboCodec::encodedBits(length, RATES[r]);
+            for (size_t i = 0; same && i < bits.size(); i++) same = bits[i] == (uint8_t)(reference[i] - '0');
+            check(same, "packed encoder matches the bit-serial encoder", round);
+
+            bool passed = false;
+            check(codec.decode(bits, RATES[r], TurboCodec::DEFAULT_ITERATIONS, &passed) == message && passed,
+                  "clean frame round trip", round);
+            round++;
+        }
+    }
+
+    // Longer than the interleaver cache: only the string encoder takes it, the decoder shuffles uncached.
+    // One weak wrong systematic bit among confident ones makes the decoder iterate
+    std::string message = randomMessage(200);
+    std::string coded = codec.encode(message, TurboCodec::RATE_1_3);
+    std::vector<int16_t> llr(coded.size());
+    for (size_t i = 0; i < coded.size(); i++) llr[i] = coded[i] == '1' ? 4 * TurboCodec::HARD_BIT_LLR : -4 * TurboCodec::HARD_BIT_LLR;
+    llr[300] = llr[300] > 0 ? -4 : 4;
+    const size_t dataBits = (message.size() + TurboCodec::CRC_BYTES) * 8;
+    std::vector<uint8_t> decided(dataBits);
+    bool passed = codec.decodeSoft(llr.data(), dataBits, decided.data(), TurboCodec::RATE_1_3);
+    for (size_t i = 0; passed && i < message.size() * 8; i++) passed = decided[i] == ((message[i / 8] >> (7 - i % 8)) & 1);
+    check(passed, "uncached interleaver round trip", 0);
+}
+
+// Both trellises end in state 0 after their tail bits: the packed encoder writes the tail parity of the
+// reference, and an error on the last systematic bit, decided by the trellis end, is corrected
+static void checkTermination(TurboCodec &codec) {
+    for (size_t r = 0; r < TurboCodec::PUNCTURING_COUNT; r++) {
+        std::string message = randomMessage(96);
+        std::vector<uint8_t> bits = encodeBits(codec, message, RATES[r]);
+        const size_t dataBits = (message.size() + TurboCodec::CRC_BYTES) * 8;
+
+        std::vector<int16_t> llr(bits.size());
+        for (size_t i = 0; i < bits.size(); i++) llr[i] = bits[i] ? TurboCodec::HARD_BIT_LLR : -TurboCodec::HARD_BIT_LLR;
+
+        // Zero tail input from the final state of either encoder: re-encoding the message alone must
+        // write the same tail parity, whatever the data before it
+        std::string reference = codec.encode(message, RATES[r]);
+        bool same = true;
+        for (size_t i = bits.size() - TurboCodec::TAIL_BITS; i < bits.size(); i++) same &= bits[i] == (uint8_t)(reference[i] - '0');
+        check(same, "tail parity bits", (int)r);
+
+        // One error on the last systematic bit, the trellis end decides it
+        const size_t last = bits.size() - TurboCodec::TAIL_BITS - TurboCodec::codedBitsPerByte(RATES[r]) / 8;
+        llr[last] = -llr[last];
+        std::vector<uint8_t> decided(dataBits);
+        check(codec.decodeSoft(llr.data(), dataBits, decided.data(), RATES[r]), "error next to the tail", (int)r);
+    }
+}
+
+// Every coded bit of a 96-byte frame flipped on its own: a corrected frame must be the sent message,
+// an uncorrected one must fail its CRC, never pass it with wrong data
+static void checkSingleBitSweep(TurboCodec &codec) {
+    for (size_t r = 0; r < TurboCodec::PUNCTURING_COUNT; r++) {
+        std::string message = randomMessage(96);
+        std::vector<uint8_t> bits = encodeBits(codec, message, RATES[r]);
+        int uncorrected = 0, miscorrected = 0, tailUncorrected = 0;
+        for (size_t i = 0; i < bits.size(); i++) {
+            bits[i] ^= 1;
+            bool passed = false;
+            std::string decoded = codec.decode(bits, RATES[r], TurboCodec::DEFAULT_ITERATIONS, &passed);
+            bits[i] ^= 1;
+            if (passed && decoded != message) miscorrected++;
+            if (!passed) {
+                uncorrected++;
+                tailUncorrected += i >= bits.size() - TurboCodec::TAIL_BITS ? 1 : 0;
+            }
+        }
+        printf("rate %s: %d of %zu single-bit errors uncorrected (%d on the tail), %d miscorrected\n",
+               RATE_NAMES[r], uncorrected, bits.size(), tailUncorrected, miscorrected);
+        check(miscorrected == 0, "single-bit sweep miscorrection", (int)r);
+        check(uncorrected <= SWEEP_LIMIT[r], "single-bit sweep uncorrected count", (int)r);
+    }
+}
+
+// Hard-decision frames through a binary symmetric channel, frame errors out of FER_FRAMES
+static void checkFrameErrorRate(TurboCodec &codec) {
+    printf("FER of %d 96-byte frames per cell, hard decisions, %d iterations\n", FER_FRAMES,
+           TurboCodec::DEFAULT_ITERATIONS);
+    printf("rate  BER %.4f  BER %.4f  BER %.4f\n", FER_BER[0], FER_BER[1], FER_BER[2]);
+    for (size_t r = 0; r < TurboCodec::PUNCTURING_COUNT; r++) {
+        printf("%-5s", RATE_NAMES[r]);
+        for (size_t b = 0; b < 3; b++) {
+            std::bernoulli_distribution flip(FER_BER[b]);
+            int frameErrors = 0, miscorrected = 0;
+            for (int f = 0; f < FER_FRAMES; f++) {
+                std::string message = randomMessage(96);
+                std::vector<uint8_t> bits = encodeBits(codec, message, RATES[r]);
+                for (uint8_t &bit : bits) bit ^= flip(rng) ? 1 : 0;
+                bool passed = false;
+                std::string decoded = codec.decode(bits, RATES[r], TurboCodec::DEFAULT_ITERATIONS, &passed);
+                frameErrors += passed ? 0 : 1;
+                miscorrected += passed && decoded != message ? 1 : 0;
+            }
+            printf("   %3d/%d", frameErrors, FER_FRAMES);
+            check(miscorrected == 0, "FER miscorrection", (int)(r * 3 + b));
+            check(frameErrors <= FER_LIMIT[r][b], "FER limit", (int)(r * 3 + b));
+        }
+        printf("\n");
+    }
+}
+
+// Messages and buffers the encoder and decoder refuse
+static void checkRejection(TurboCodec &codec) {
+    std::vector<uint8_t> message(TurboCodec::MAX_INPUT_BYTES + 1), out(TurboCodec::encodedBytes(message.size()));
+    check(codec.encode(message.data(), message.size(), out.data(), out.size()) == 0, "message too long", 0);
+    check(codec.encode(message.data(), 10, out.data(), TurboCodec::encodedBytes(10) - 1) == 0, "output too small", 0);
+    check(codec.encode(message.data(), 10, out.data(), out.size(), (TurboCodec::Puncturing)TurboCodec::PUNCTURING_COUNT) == 0,
+          "unknown puncturing", 0);
+
+    bool passed = true;
+    std::vector<uint8_t> bits(TurboCodec::TAIL_BITS + 2 * TurboCodec::codedBitsPerByte(TurboCodec::RATE_1_3));
+    check(codec.decode(bits, TurboCodec::RATE_1_3, TurboCodec::DEFAULT_ITERATIONS, &passed).empty() && !passed,
+          "frame without a message byte", 0);
+}
+
+int main() {
+    static TurboCodec codec;
+    checkRoundTrip(codec);
+    checkTermination(codec);
+    checkRejection(codec);
+    checkSingleBitSweep(codec);
+    checkFrameErrorRate(codec);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All Turbo checks passed\n");
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "DecodeStats.hpp"
+
+/**
+ * @brief Constructor for the DecodeStats class.
+ */
+DecodeStats::DecodeStats()
+    : next(0), count(0), failedFrames(0), erasureTotal(0), errorTotal(0) {
+    memset(entries, 0, sizeof(entries));
+    memset(symbolHistogram, 0, sizeof(symbolHistogram));
+    memset(positionHistogram, 0, sizeof(positionHistogram));
+}
+
+/**
+ * @brief Adds the result of one frame, dropping the oldest frame once the window is full.
+ * @param result Decode result filled by the Reed-Solomon decoder.
+ * @param codewordLength Length of the codeword.
+ */
+void DecodeStats::record(const RS::DecodeResult& result, size_t codewordLength) {
+    Entry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.failed = result.status != RS::RESULT_SUCCESS;
+
+    if (!entry.failed) {
+        size_t symbols = result.erasures + result.errors;
+        entry.symbols = symbols < MAX_SYMBOLS ? symbols : MAX_SYMBOLS;
+        entry.erasures = result.erasures;
+        entry.errors = result.errors;
+
+        uint8_t positions = RS::ResultPositions(&result);
+        for (uint8_t i = 0; i < positions && codewordLength > 0; i++) {
+            size_t bin = result.positions[i] * POSITION_BINS / codewordLength;
+            entry.positionBins[bin < POSITION_BINS ? bin : POSITION_BINS - 1]++;
+        }
+    }
+
+    if (count == WINDOW) {
+        apply(entries[next], -1);
+    } else {
+        count++;
+    }
+    entries[next] = entry;
+    apply(entry, 1);
+    next = (next + 1) % WINDOW;
+}
+
+/**
+ * @brief Adds or removes one frame from the histograms.
+ * @param entry The frame.
+ * @param sign 1 to add, -1 to remove.
+ */
+void DecodeStats::apply(const Entry& entry, int sign) {
+    if (entry.failed) {
+        failedFrames += sign;
+        return;
+    }
+    erasureTotal += sign * entry.erasures;
+    errorTotal += sign * entry.errors;
+    symbolHistogram[entry.symbols] += sign;
+    for (size_t i = 0; i < POSITION_BINS; i++) {
+        positionHistogram[i] += sign * entry.positionBins[i];
+    }
+}
+
+/**
+ * @brief Prints the window as one "STATS:" line.
+ */
+void DecodeStats::print() const {
+    Serial.print("STATS:");
+    Serial.print(count);
+    Serial.print(",");
+    Serial.print(failedFrames);
+    Serial.print(",");
+    Serial.print(erasureTotal);
+    Serial.print(",");
+    Serial.print(errorTotal);
+
+    // The histogram ends at the largest non-empty bin
+    size_t last = 0;
+    for (size_t i = 0; i <= MAX_SYMBOLS; i++) {
+        if (symbolHistogram[i] != 0) {
+            last = i;
+        }
+    }
+    Serial.print(",sym=");
+    for (size_t i = 0; i <= last; i++) {
+        if (i > 0) {
+            Serial.print("/");
+        }
+        Serial.print(symbolHistogram[i]);
+    }
+
+    Serial.print(",pos=");
+    for (size_t i = 0; i < POSITION_BINS; i++) {
+        if (i > 0) {
+            Serial.print("/");
+        }
+        Serial.print(positionHistogram[i]);
+    }
+    Serial.println();
+}
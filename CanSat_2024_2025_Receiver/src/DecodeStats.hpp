@@ -0,0 +1,74 @@
+#ifndef DECODESTATS_HPP
+#define DECODESTATS_HPP
+
+#include <Arduino.h>
+#include <RS-FEC.h>
+
+/**
+ * @class DecodeStats
+ * @brief Rolling histograms of the Reed-Solomon decode results of the last WINDOW frames.
+ *
+ * Corrected symbols per frame is the earliest sign of a shrinking link margin: it rises
+ * well before frames start to fail. The counts are exported over Serial as one "STATS:" line.
+ */
+class DecodeStats {
+public:
+    static const size_t WINDOW = 64;       ///< Frames kept in the rolling window
+    static const size_t MAX_SYMBOLS = 32;  ///< Strongest Reed-Solomon code, last histogram bin
+    static const size_t POSITION_BINS = 8; ///< Codeword position histogram bins
+
+    /**
+     * @brief Constructor for the DecodeStats class, starts with an empty window.
+     */
+    DecodeStats();
+
+    /**
+     * @brief Adds the result of one frame, dropping the oldest frame once the window is full.
+     * @param result Decode result filled by the Reed-Solomon decoder.
+     * @param codewordLength Length of the (shortened) codeword, used to bin the positions.
+     */
+    void record(const RS::DecodeResult& result, size_t codewordLength);
+
+    /**
+     * @brief Prints the window as one "STATS:" line.
+     *        Format: frames, failed, erasures, errors, then "sym=" with the frame count for
+     *        0..MAX_SYMBOLS corrected symbols and "pos=" with the corrections per codeword eighth.
+     */
+    void print() const;
+
+    /**
+     * @brief Gets the number of frames in the window.
+     * @return Number of frames, never more than WINDOW.
+     */
+    size_t frames() const { return count; }
+
+private:
+    /**
+     * @brief Compact result of one frame.
+     */
+    struct Entry {
+        uint8_t symbols;                      ///< Erasures plus errors, capped at MAX_SYMBOLS
+        uint8_t erasures;                     ///< Known erasures passed to the decoder
+        uint8_t errors;                       ///< Errors located by the decoder
+        bool failed;                          ///< The frame could not be decoded
+        uint8_t positionBins[POSITION_BINS];  ///< Corrections per codeword eighth
+    };
+
+    /**
+     * @brief Adds or removes one frame from the histograms.
+     * @param entry The frame.
+     * @param sign 1 to add, -1 to remove.
+     */
+    void apply(const Entry& entry, int sign);
+
+    Entry entries[WINDOW];                    ///< Ring buffer of the last WINDOW frames
+    size_t next;                              ///< Ring buffer slot of the next frame
+    size_t count;                             ///< Frames in the window
+    uint16_t failedFrames;                    ///< Failed frames in the window
+    uint16_t erasureTotal;                    ///< Erasures in the window
+    uint16_t errorTotal;                      ///< Errors in the window
+    uint16_t symbolHistogram[MAX_SYMBOLS + 1]; ///< Decoded frames per corrected symbol count
+    uint16_t positionHistogram[POSITION_BINS]; ///< Corrections per codeword eighth
+};
+
+#endif // DECODESTATS_HPP
@@ -0,0 +1,100 @@
+#include "ErasureHints.hpp"
+
+/**
+ * @brief Constructor for the ErasureHints class.
+ * @param msgLen Message length of the codeword.
+ * @param eccLen ECC length of the codeword.
+ */
+ErasureHints::ErasureHints(size_t msgLen, size_t eccLen) {
+    reset(msgLen, eccLen);
+}
+
+/**
+ * @brief Drops all collected hints and sets the codeword shape for the next ones.
+ * @param msgLen Message length of the codeword.
+ * @param eccLen ECC length of the codeword.
+ */
+void ErasureHints::reset(size_t msgLen, size_t eccLen) {
+    this->msgLen = msgLen < MAX_MSG_LEN ? msgLen : MAX_MSG_LEN;
+    this->eccLen = eccLen < MAX_ECC_LEN ? eccLen : MAX_ECC_LEN;
+    // Measured on shortened codewords with one error past the remaining capacity, the margin keeps
+    // wrong decodes near 1% for ECC 32, 0.2% for ECC 16 and, halved to 4, 1% for ECC 8
+    size_t margin = this->eccLen / 2 < DETECTION_MARGIN ? this->eccLen / 2 : DETECTION_MARGIN;
+    cap = this->eccLen - margin;
+    memset(marked, 0, sizeof(marked));
+    eraseCount = 0;
+}
+
+/**
+ * @brief Adds one position unless it is already marked or the cap is reached.
+ * @param pos Codeword position to mark.
+ */
+void ErasureHints::mark(size_t pos) {
+    if (pos >= msgLen + eccLen || marked[pos] || eraseCount >= cap) {
+        return;
+    }
+    marked[pos] = true;
+    erasePos[eraseCount++] = (uint8_t)pos;
+}
+
+/**
+ * @brief Marks every codeword byte that did not arrive.
+ * @param receivedLength Number of codeword bytes present in the packet.
+ */
+void ErasureHints::markTruncated(size_t receivedLength) {
+    for (size_t i = receivedLength; i < msgLen + eccLen; i++) {
+        mark(i);
+    }
+}
+
+/**
+ * @brief Marks the codeword bytes flagged in a missing-byte mask.
+ * @param missing Mask with a non-zero entry for every byte that did not arrive.
+ * @param length Number of entries in the mask.
+ */
+void ErasureHints::markMissing(const uint8_t* missing, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (missing[i]) {
+            mark(i);
+        }
+    }
+}
+
+/**
+ * @brief Marks message bytes that disagree with the Turbo-decoded copy of the frame.
+ * @param codeword The received Reed-Solomon codeword.
+ * @param turboData The data bytes decoded from the Turbo-coded copy.
+ * @return true if the Turbo copy was compared.
+ */
+bool ErasureHints::markTurboDisagreement(const char* codeword, const std::string& turboData) {
+    // The message is the telemetry frame itself
+    size_t dataLength = turboData.size();
+    if (dataLength == 0 || dataLength != msgLen) {
+        return false;
+    }
+
+    for (size_t i = 0; i < dataLength; i++) {
+        if (codeword[i] != turboData[i]) {
+            mark(i);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Marks the telemetry frame bytes that make a field leave its physical range.
+ * @param codeword The received Reed-Solomon codeword.
+ */
+void ErasureHints::markFraming(const char* codeword) {
+    // ECC bytes can take any value, only a key frame, alone or in front of a pressure batch, is checked
+    if (msgLen < TelemetryFrame::SIZE ||
+        (msgLen > TelemetryFrame::SIZE && (uint8_t)codeword[0] != TelemetryFrame::VERSION)) {
+        return;
+    }
+    uint8_t positions[TelemetryFrame::SIZE];
+    size_t count = TelemetryFrame::implausibleBytes((const uint8_t*)codeword, TelemetryFrame::SIZE, positions,
+                                                    sizeof(positions));
+    for (size_t i = 0; i < count; i++) {
+        mark(positions[i]);
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef ERASUREHINTS_HPP
+#define ERASUREHINTS_HPP
+
+#include <Arduino.h>
+#include <vector>
+#include <string>
+#include <TelemetryFrame.h>
+
+/**
+ * @class ErasureHints
+ * @brief Collects the codeword positions that are known to be unreliable, so they can be
+ *        passed to ReedSolomon::Decode as erasures (an erasure costs one ECC byte, an unknown error two).
+ *
+ * Hints are added in order of confidence: missing bytes of a truncated or lost packet, bytes that
+ * disagree with the decoded Turbo copy, then telemetry frame bytes that decode to impossible values.
+ * They are capped DETECTION_MARGIN symbols below the ECC length: erasures that fill the whole ECC
+ * leave no redundancy to notice a wrong decode, and RS<96,32> with 32 erasures and one more error
+ * returns wrong data every time.
+ */
+class ErasureHints {
+public:
+    static const size_t MAX_MSG_LEN = 96;                             ///< Longest Reed-Solomon message
+    static const size_t MAX_ECC_LEN = 32;                             ///< Strongest Reed-Solomon code
+    static const size_t MAX_CODEWORD_LEN = MAX_MSG_LEN + MAX_ECC_LEN; ///< Longest Reed-Solomon codeword
+    static const size_t DETECTION_MARGIN = 6; ///< ECC symbols never spent on erasures, at most half the ECC
+
+    /**
+     * @brief Constructor for the ErasureHints class, starts with no hints.
+     * @param msgLen Message length of the (shortened) codeword.
+     * @param eccLen ECC length of the codeword.
+     */
+    ErasureHints(size_t msgLen, size_t eccLen);
+
+    /**
+     * @brief Drops all collected hints and sets the codeword shape for the next ones.
+     * @param msgLen Message length of the (shortened) codeword.
+     * @param eccLen ECC length of the codeword.
+     */
+    void reset(size_t msgLen, size_t eccLen);
+
+    /**
+     * @brief Marks every codeword byte that did not arrive.
+     * @param receivedLength Number of codeword bytes present in the packet.
+     */
+    void markTruncated(size_t receivedLength);
+
+    /**
+     * @brief Marks the codeword bytes flagged in a missing-byte mask (lost packets of an interleaved group).
+     * @param missing Mask with a non-zero entry for every byte that did not arrive.
+     * @param length Number of entries in the mask.
+     */
+    void markMissing(const uint8_t* missing, size_t length);
+
+    /**
+     * @brief Marks message bytes that disagree with the Turbo-decoded copy of the frame.
+     * @param codeword The received Reed-Solomon codeword.
+     * @param turboData The data bytes decoded from the Turbo-coded copy.
+     * @return true if the Turbo copy matched the message length and was compared.
+     */
+    bool markTurboDisagreement(const char* codeword, const std::string& turboData);
+
+    /**
+     * @brief Marks the telemetry frame bytes that make a field leave its physical range.
+     * @param codeword The received Reed-Solomon codeword.
+     */
+    void markFraming(const char* codeword);
+
+    /**
+     * @brief Gets the collected erasure positions.
+     * @return Pointer to count() codeword positions.
+     */
+    uint8_t* positions() { return erasePos; }
+
+    /**
+     * @brief Gets the number of collected erasure positions.
+     * @return Number of erasures, never more than the ECC length minus the detection margin.
+     */
+    size_t count() const { return eraseCount; }
+
+private:
+    /**
+     * @brief Adds one position unless it is already marked or the cap is reached.
+     * @param pos Codeword position to mark.
+     */
+    void mark(size_t pos);
+
+    size_t msgLen;                 ///< Message length of the current codeword
+    size_t eccLen;                 ///< ECC length of the current codeword
+    size_t cap;                    ///< Most erasures of the current codeword
+    bool marked[MAX_CODEWORD_LEN]; ///< Positions already in the list
+    uint8_t erasePos[MAX_ECC_LEN]; ///< Erasure positions for ReedSolomon::Decode
+    size_t eraseCount;             ///< Number of valid entries in erasePos
+};
+
+#endif // ERASUREHINTS_HPP
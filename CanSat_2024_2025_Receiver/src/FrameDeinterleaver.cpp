@@ -0,0 +1,135 @@
+#include "FrameDeinterleaver.hpp"
+
+/**
+ * @brief Constructor for the FrameDeinterleaver class.
+ */
+FrameDeinterleaver::FrameDeinterleaver()
+    : active(false), startTime(0), groupId(0), depth(0), packetCount(0), receivedPackets(0), firstSequence(0),
+      slotLen(0) {}
+
+/**
+ * @brief Validates the group header of a packet.
+ * @param data Packet bytes.
+ * @param length Packet length in bytes.
+ * @return true if the header fields are consistent.
+ */
+bool FrameDeinterleaver::validHeader(const uint8_t* data, size_t length) {
+    if (length < GROUP_HEADER_SIZE) {
+        return false;
+    }
+    uint8_t depth = data[1];
+    uint8_t index = data[2] >> 4;
+    uint8_t count = data[2] & 0x0F;
+    size_t slotLen = data[3];
+    if (depth < 1 || depth > MAX_DEPTH || count < 1 || index >= count || slotLen < 1 || slotLen > MAX_CODEWORD) {
+        return false;
+    }
+
+    // The chunk must have exactly the length the sender cuts for this index
+    size_t total = depth * slotLen;
+    size_t chunk = (total + count - 1) / count;
+    size_t start = index * chunk;
+    if (start >= total) {
+        return false;
+    }
+    size_t end = start + chunk < total ? start + chunk : total;
+    return length == GROUP_HEADER_SIZE + depth * FRAME_HEADER_SIZE + (end - start);
+}
+
+/**
+ * @brief Checks whether a packet belongs to the group being collected.
+ * @param data Packet bytes.
+ * @param length Packet length in bytes.
+ * @return true if a group is pending and the packet carries another group id.
+ */
+bool FrameDeinterleaver::startsNewGroup(const uint8_t* data, size_t length) const {
+    return active && validHeader(data, length) && data[0] != groupId;
+}
+
+/**
+ * @brief Adds one packet to the group being collected.
+ * @param data Packet bytes.
+ * @param length Packet length in bytes.
+ * @param sequence LoRaPacket sequence number of the packet.
+ * @return true if the packet was valid and accepted.
+ */
+bool FrameDeinterleaver::addPacket(const uint8_t* data, size_t length, uint16_t sequence) {
+    if (!validHeader(data, length)) {
+        return false;
+    }
+
+    // The first valid packet fixes the group shape
+    if (!active) {
+        active = true;
+        startTime = millis();
+        groupId = data[0];
+        depth = data[1];
+        packetCount = data[2] & 0x0F;
+        slotLen = data[3];
+        receivedPackets = 0;
+        firstSequence = (uint16_t)(sequence - (data[2] >> 4)); // The packets of a group go out back to back
+        memset(packetSeen, 0, sizeof(packetSeen));
+        memcpy(headers, data + GROUP_HEADER_SIZE, depth * FRAME_HEADER_SIZE);
+        memset(stream, 0, depth * slotLen);
+        memset(streamMissing, 1, depth * slotLen);
+    }
+
+    uint8_t index = data[2] >> 4;
+    if (data[0] != groupId || data[1] != depth || (data[2] & 0x0F) != packetCount || data[3] != slotLen ||
+        packetSeen[index]) {
+        return false;
+    }
+
+    size_t total = depth * slotLen;
+    size_t chunk = (total + packetCount - 1) / packetCount;
+    size_t start = index * chunk;
+    size_t offset = GROUP_HEADER_SIZE + depth * FRAME_HEADER_SIZE;
+    memcpy(stream + start, data + offset, length - offset);
+    memset(streamMissing + start, 0, length - offset);
+
+    // Every packet repeats the frame headers, a damaged copy is replaced by a good one
+    const uint8_t* frameHeaders = data + GROUP_HEADER_SIZE;
+    for (uint8_t i = 0; i < depth; i++) {
+        const uint8_t* header = headers + i * FRAME_HEADER_SIZE;
+        const uint8_t* copy = frameHeaders + i * FRAME_HEADER_SIZE;
+        if (!validFrameHeader(header) && validFrameHeader(copy)) {
+            memcpy(headers + i * FRAME_HEADER_SIZE, copy, FRAME_HEADER_SIZE);
+        }
+    }
+
+    packetSeen[index] = true;
+    receivedPackets++;
+    return true;
+}
+
+/**
+ * @brief Checks the rate byte complement and the message length of a frame header.
+ * @param header Frame header bytes.
+ * @return true if the header looks intact.
+ */
+bool FrameDeinterleaver::validFrameHeader(const uint8_t* header) {
+    uint8_t rateIndex = header[1] & 0x0F;
+    return header[0] > 0 && (header[1] >> 4) == (~rateIndex & 0x0F);
+}
+
+/**
+ * @brief Gets the LoRaPacket sequence number of the Turbo copy of one frame of the group.
+ * @param i Frame index.
+ * @return Sequence number the sender gave the W packet of the frame.
+ */
+uint16_t FrameDeinterleaver::turboSequence(uint8_t i) const {
+    // Frames before the last one sent their copies right before the group, the last one right after it
+    if (i + 1 < depth) {
+        return (uint16_t)(firstSequence - (depth - 1) + i);
+    }
+    return (uint16_t)(firstSequence + packetCount);
+}
+
+/**
+ * @brief Restores the codewords of the pending group and ends it.
+ */
+void FrameDeinterleaver::finish() {
+    RS::Deinterleave(stream, depth, slotLen, slots);
+    RS::Deinterleave(streamMissing, depth, slotLen, slotMissing);
+    active = false;
+}
@@ -0,0 +1,145 @@
+#ifndef FRAMEDEINTERLEAVER_HPP
+#define FRAMEDEINTERLEAVER_HPP
+
+#include <Arduino.h>
+#include <RS-FEC.h>
+#include "utils.hpp"
+
+/**
+ * @class FrameDeinterleaver
+ * @brief Reassembles an interleaved frame group ("I" packets) and restores its codewords.
+ *
+ * Packet layout, as built by the sender's FrameInterleaver:
+ *   [group id][depth][packet index << 4 | packet count][slot length][depth x frame header][chunk]
+ * Bytes of packets that never arrive are reported as missing, so they can be decoded as erasures.
+ *
+ * The sender sends the Turbo ("W") copy of every frame as soon as the frame is encoded, and the group
+ * once its last frame is in: W of frames 0..depth-2, the group packets, then W of the last frame.
+ * The packet sequence numbers therefore tell which W copy belongs to which frame of the group.
+ */
+class FrameDeinterleaver {
+public:
+    static const uint8_t MAX_DEPTH = 8;         ///< Most frames per group
+    static const size_t MAX_CODEWORD = 96 + 32; ///< Longest Reed-Solomon codeword
+    static const size_t GROUP_HEADER_SIZE = 4;  ///< Group fields before the frame headers
+    static const uint8_t MAX_PACKETS = 15;      ///< Most packets per group
+
+    /**
+     * @brief Constructor for the FrameDeinterleaver class, starts with no group.
+     */
+    FrameDeinterleaver();
+
+    /**
+     * @brief Checks whether a packet belongs to the group being collected.
+     * @param data Packet bytes (payload of the LoRaPacket).
+     * @param length Packet length in bytes.
+     * @return true if a group is pending and the packet carries another group id.
+     */
+    bool startsNewGroup(const uint8_t* data, size_t length) const;
+
+    /**
+     * @brief Adds one packet to the group being collected, starting a group if none is pending.
+     * @param data Packet bytes (payload of the LoRaPacket).
+     * @param length Packet length in bytes.
+     * @param sequence LoRaPacket sequence number of the packet.
+     * @return true if the packet was valid and accepted.
+     */
+    bool addPacket(const uint8_t* data, size_t length, uint16_t sequence);
+
+    /**
+     * @brief Checks whether a group is being collected.
+     * @return true if at least one packet of the group arrived.
+     */
+    bool pending() const { return active; }
+
+    /**
+     * @brief Checks whether every packet of the pending group arrived.
+     * @return true if the group is complete.
+     */
+    bool complete() const { return active && receivedPackets == packetCount; }
+
+    /**
+     * @brief Gets the millis() time of the first packet of the pending group.
+     * @return Start time of the pending group.
+     */
+    unsigned long startedAt() const { return startTime; }
+
+    /**
+     * @brief Restores the codewords of the pending group and ends it.
+     *        Missing bytes are zero and flagged in the missing masks.
+     */
+    void finish();
+
+    /**
+     * @brief Gets the number of frames of the finished group.
+     * @return Number of frames.
+     */
+    uint8_t frameCount() const { return depth; }
+
+    /**
+     * @brief Gets the frame header of one frame of the finished group.
+     * @param i Frame index.
+     * @return Pointer to FRAME_HEADER_SIZE bytes.
+     */
+    const uint8_t* frameHeader(uint8_t i) const { return headers + i * FRAME_HEADER_SIZE; }
+
+    /**
+     * @brief Gets the restored codeword slot of one frame (slotLength() bytes, zero padded).
+     * @param i Frame index.
+     * @return Pointer to the codeword.
+     */
+    const uint8_t* codeword(uint8_t i) const { return slots + i * slotLen; }
+
+    /**
+     * @brief Gets the missing-byte mask of one frame (slotLength() entries).
+     * @param i Frame index.
+     * @return Pointer to the mask, 1 for bytes that did not arrive.
+     */
+    const uint8_t* missing(uint8_t i) const { return slotMissing + i * slotLen; }
+
+    /**
+     * @brief Gets the slot length of the finished group.
+     * @return Longest codeword of the group.
+     */
+    size_t slotLength() const { return slotLen; }
+
+    /**
+     * @brief Gets the LoRaPacket sequence number of the Turbo copy of one frame of the group.
+     * @param i Frame index.
+     * @return Sequence number the sender gave the W packet of the frame.
+     */
+    uint16_t turboSequence(uint8_t i) const;
+
+private:
+    bool active;                                     ///< A group is being collected
+    unsigned long startTime;                         ///< millis() of the first packet
+    uint8_t groupId;                                 ///< Id of the pending group
+    uint8_t depth;                                   ///< Frames in the group
+    uint8_t packetCount;                             ///< Packets in the group
+    uint8_t receivedPackets;                         ///< Packets received so far
+    uint16_t firstSequence;                          ///< Sequence number of packet 0 of the group
+    bool packetSeen[MAX_PACKETS];                    ///< Packets already stored
+    size_t slotLen;                                  ///< Longest codeword of the group
+    uint8_t headers[MAX_DEPTH * FRAME_HEADER_SIZE];  ///< Frame headers of the group
+    uint8_t stream[MAX_DEPTH * MAX_CODEWORD];        ///< Interleaved stream
+    uint8_t streamMissing[MAX_DEPTH * MAX_CODEWORD]; ///< Stream bytes not received yet
+    uint8_t slots[MAX_DEPTH * MAX_CODEWORD];         ///< Restored codewords
+    uint8_t slotMissing[MAX_DEPTH * MAX_CODEWORD];   ///< Restored missing masks
+
+    /**
+     * @brief Validates the group header of a packet.
+     * @param data Packet bytes.
+     * @param length Packet length in bytes.
+     * @return true if the header fields are consistent.
+     */
+    static bool validHeader(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Checks the rate byte complement and the message length of a frame header.
+     * @param header Frame header bytes.
+     * @return true if the header looks intact.
+     */
+    static bool validFrameHeader(const uint8_t* header);
+};
+
+#endif // FRAMEDEINTERLEAVER_HPP
@@ -6,7 +6,10 @@
  * @details Initializes LoRa settings with provided configuration values.
  */
 LoRaHandler::LoRaHandler(int cs, int rst, int dio0, float freq, int sf, int sw, long bw, int cr)
-    : csPin(cs), rstPin(rst), dio0Pin(dio0), frequency(freq), spreadingFactor(sf), syncWord(sw), bandwidth(bw), codingRate(cr) {}
+    : csPin(cs), rstPin(rst), dio0Pin(dio0), frequency(freq), spreadingFactor(sf), syncWord(sw), bandwidth(bw), codingRate(cr),
+      nextSequence(0), sequenceKnown(false) {
+    resetCounters();
+}
 
 /**
  * @brief Initializes the LoRa module.
@@ -48,13 +51,44 @@ void LoRaHandler::deselect() {
 }
 
 /**
- * @brief Reads a packet received via LoRa.
- * @return A String containing the received data, or an empty String if no packet is received.
+ * @brief Reads a packet received via LoRa and checks its header.
+ * @param header Filled with the header of the packet.
+ * @return Pointer to the payload bytes, or nullptr if no packet arrived or it was rejected.
  */
-String LoRaHandler::receivePacket() {
+const uint8_t* LoRaHandler::receivePacket(LoRaPacket::Header& header) {
     int packetSize = LoRa.parsePacket(); // Check for packet
-    if (packetSize) {
-        return LoRa.readString(); // Return the received data as a String
+    if (packetSize <= 0) {
+        return nullptr; // No data received
+    }
+
+    // Read the raw bytes, draining anything longer than a LoRa packet
+    size_t length = 0;
+    while (LoRa.available()) {
+        int value = LoRa.read();
+        if (length < sizeof(buffer)) {
+            buffer[length++] = (uint8_t)value;
+        }
     }
-    return ""; // No data received
+
+    if (!LoRaPacket::parse(buffer, length, header)) {
+        linkCounters.rejected++;
+        return nullptr;
+    }
+    linkCounters.received++;
+
+    // Every gap in the sequence numbers is a lost packet
+    uint16_t gap = header.sequence - nextSequence;
+    if (sequenceKnown && gap < MAX_SEQUENCE_GAP) {
+        linkCounters.lost += gap;
+    }
+    nextSequence = header.sequence + 1;
+    sequenceKnown = true;
+    return buffer + LoRaPacket::HEADER_SIZE;
+}
+
+/**
+ * @brief Clears the packet counters.
+ */
+void LoRaHandler::resetCounters() {
+    memset(&linkCounters, 0, sizeof(linkCounters));
 }
@@ -4,12 +4,28 @@
 #include <Arduino.h>
 #include <LoRa.h>
 #include <SPI.h>
+#include <LoRaPacket.h>
 
 /**
  * @class LoRaHandler
  * @brief Handles the initialization and communication with the LoRa module.
+ *
+ * Received packets are checked against their LoRaPacket header before they are handed on,
+ * and the sequence numbers of the valid ones give the number of lost packets.
  */
 class LoRaHandler {
+public:
+    static const uint16_t MAX_SEQUENCE_GAP = 1024; ///< Larger jumps are a sender restart, not lost packets
+
+    /**
+     * @brief Packet counters since the last resetCounters.
+     */
+    struct LinkCounters {
+        uint32_t received; ///< Packets with a valid header
+        uint32_t lost;     ///< Packets missing from the sequence numbers
+        uint32_t rejected; ///< Packets dropped for a bad header or length
+    };
+
 private:
     int csPin;            ///< Chip Select (CS) pin
     int rstPin;           ///< Reset pin
@@ -19,6 +35,10 @@ private:
     int syncWord;         ///< LoRa synchronization word
     long bandwidth;       ///< Signal bandwidth in Hz
     int codingRate;       ///< Coding rate for LoRa (e.g., 4/5)
+    uint8_t buffer[LoRaPacket::MAX_PACKET]; ///< Last received packet
+    uint16_t nextSequence; ///< Sequence number expected next
+    bool sequenceKnown;   ///< A valid packet arrived, so nextSequence is set
+    LinkCounters linkCounters; ///< Packet counters since the last reset
 
 public:
     /**
@@ -53,10 +73,23 @@ public:
     void deselect();
 
     /**
-     * @brief Reads a packet of data received via LoRa.
-     * @return A String containing the received data. Returns an empty String if no data is received.
+     * @brief Reads a packet received via LoRa and checks its header.
+     * @param header Filled with the header of the packet.
+     * @return Pointer to the header.length payload bytes, valid until the next call,
+     *         or nullptr if no packet arrived or it was rejected.
+     */
+    const uint8_t* receivePacket(LoRaPacket::Header& header);
+
+    /**
+     * @brief Gets the packet counters since the last resetCounters.
+     * @return The packet counters.
+     */
+    const LinkCounters& counters() const { return linkCounters; }
+
+    /**
+     * @brief Clears the packet counters, the expected sequence number is kept.
      */
-    String receivePacket();
+    void resetCounters();
 };
 
 #endif // LORAHANDLER_HPP
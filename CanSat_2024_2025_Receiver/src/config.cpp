@@ -8,7 +8,14 @@ LoRaHandler lora(LORA_CS, LORA_RST, LORA_DIO0, LORA_BAND, LORA_SF, LORA_SW, LORA
 const uint8_t ECC_LENGTH = 32; ///< Length of the error correction code
 const int messageSize = 96;    ///< Size of the message for Reed-Solomon
 char repaired[messageSize];    ///< Buffer to store the repaired message
-RS::ReedSolomon<96, 32> rs;    ///< Instance of the Reed-Solomon encoder/decoder
+
+// Same table as the sender, the frame header carries the index
+const RS::CodeRate codeRates[] = {
+    RS::ShortenedCode<96, 8>::rate(),
+    RS::ShortenedCode<96, 16>::rate(),
+    RS::ShortenedCode<96, 32>::rate(),
+};
+const size_t codeRateCount = sizeof(codeRates) / sizeof(codeRates[0]); ///< Number of code rates
 
 // Message counters
 int pMessageNumber = 0; ///< Counter for "P" messages
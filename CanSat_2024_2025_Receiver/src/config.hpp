@@ -39,7 +39,8 @@ extern LoRaHandler lora; ///< Instance of the LoRa handler
 extern const uint8_t ECC_LENGTH; ///< Error correction code length
 extern const int messageSize;    ///< Size of the Reed-Solomon message
 extern char repaired[];          ///< Buffer for repaired message data
-extern RS::ReedSolomon<96, 32> rs; ///< Instance of Reed-Solomon encoder/decoder
+extern const RS::CodeRate codeRates[]; ///< Shortened Reed-Solomon codes the sender can choose per frame
+extern const size_t codeRateCount;     ///< Number of entries in codeRates
 
 // Counters for message numbering
 extern int pMessageNumber; ///< Counter for "P" type messages
@@ -40,6 +40,138 @@
 #include <Arduino.h>
 #include "config.hpp"
 #include "utils.hpp"
+#include "FrameDeinterleaver.hpp"
+#include "DecodeStats.hpp"
+#include <TurboCodec.h>
+
+// The sender transmits the Reed-Solomon ("P") packet and then the Turbo ("W") copy of the same frame,
+// so the W copy carries the next sequence number. The P codeword is held until its W copy arrives,
+// so both can be used for the erasure hints.
+#define PENDING_TIMEOUT_MS 3000 ///< Decode a held P codeword without its Turbo copy after this time
+
+static std::string pendingPayload;     ///< Held "P" payload waiting for its Turbo copy
+static bool pendingValid = false;      ///< True if pendingPayload holds an undecoded codeword
+static unsigned long pendingSince = 0; ///< millis() when pendingPayload was received
+static uint16_t pendingSequence = 0;   ///< Packet sequence number of pendingPayload
+
+static TurboCodec turboCodec; ///< Decodes the Turbo ("W") copy of every frame
+
+// Interleaved groups ("I" packets) are decoded once every packet and the Turbo copy of the last frame
+// arrived, a packet of the next group arrives, or the timeout passes; lost packets become erasures.
+#define GROUP_TIMEOUT_MS 3000 ///< Decode an incomplete interleaved group after this time
+
+static FrameDeinterleaver deinterleaver; ///< Collects the packets of one interleaved group
+
+/**
+ * @brief A Turbo copy that passed its CRC, kept for the frames of the next interleaved group.
+ */
+struct TurboCopy {
+    bool valid;        ///< True if data holds a verified copy
+    uint16_t sequence; ///< Sequence number of the W packet
+    std::string data;  ///< Decoded frame bytes
+};
+
+static TurboCopy turboCopies[FrameDeinterleaver::MAX_DEPTH]; ///< Recent copies, indexed by sequence number
+
+/**
+ * @brief Finds the verified Turbo copy sent with a given sequence number.
+ * @param sequence Sequence number of the W packet.
+ * @return The decoded copy, or nullptr if it was lost or failed its CRC.
+ */
+static const std::string* findTurboCopy(uint16_t sequence) {
+    const TurboCopy& copy = turboCopies[sequence % FrameDeinterleaver::MAX_DEPTH];
+    return copy.valid && copy.sequence == sequence ? &copy.data : nullptr;
+}
+
+// Rolling decode statistics, printed as a "STATS:" line every STATS_INTERVAL frames
+#define STATS_INTERVAL 16 ///< Frames between two "STATS:" lines
+
+static DecodeStats decodeStats; ///< Corrected symbols of the last DecodeStats::WINDOW frames
+
+/**
+ * @brief Prints the Turbo decoder counters since the last report as one "TURBO:" line, then clears them.
+ *        Format: frames, CRC passed, average half-iterations, average and longest decode time in microseconds.
+ */
+static void printTurboCounters() {
+    const TurboCodec::DecodeCounters& counters = turboCodec.counters();
+    uint32_t frames = counters.frames > 0 ? counters.frames : 1;
+    Serial.print("TURBO:");
+    Serial.print(counters.frames);
+    Serial.print(",");
+    Serial.print(counters.crcPassed);
+    Serial.print(",");
+    Serial.print((float)counters.halfIterations / frames, 1);
+    Serial.print(",");
+    Serial.print(counters.totalMicros / frames);
+    Serial.print(",");
+    Serial.println(counters.maxMicros);
+    turboCodec.resetCounters();
+}
+
+/**
+ * @brief Prints the packet counters since the last report as one "LINK:" line, then clears them.
+ *        Format: packets received, packets lost (sequence gaps), packets rejected for a bad header.
+ */
+static void printLinkCounters() {
+    const LoRaHandler::LinkCounters& counters = lora.counters();
+    Serial.print("LINK:");
+    Serial.print(counters.received);
+    Serial.print(",");
+    Serial.print(counters.lost);
+    Serial.print(",");
+    Serial.println(counters.rejected);
+    lora.resetCounters();
+}
+
+/**
+ * @brief Prints the decode statistics once every STATS_INTERVAL frames.
+ */
+static void reportStats() {
+    if (pMessageNumber % STATS_INTERVAL == 0) {
+        decodeStats.print();
+        printTurboCounters();
+        printLinkCounters();
+    }
+}
+
+/**
+ * @brief Decodes the held "P" codeword, if any.
+ * @param turboData Turbo-decoded copy of the same frame, or nullptr if it did not arrive.
+ */
+static void decodePending(const std::string* turboData) {
+    if (!pendingValid) {
+        return;
+    }
+    pendingValid = false;
+
+    // Decode the message using Reed-Solomon and update OLED display
+    Utils::decodeMessage(pendingPayload, codeRates, codeRateCount, repaired, oled, pMessageNumber, turboData,
+                         &decodeStats);
+
+    // Increment the message counter for "P" type messages
+    pMessageNumber++;
+    reportStats();
+}
+
+/**
+ * @brief Decodes every frame of the pending interleaved group, if any.
+ */
+static void decodeGroup() {
+    if (!deinterleaver.pending()) {
+        return;
+    }
+    deinterleaver.finish();
+
+    for (uint8_t i = 0; i < deinterleaver.frameCount(); i++) {
+        Utils::decodeFrame(deinterleaver.frameHeader(i), deinterleaver.codeword(i), deinterleaver.slotLength(),
+                           deinterleaver.missing(i), codeRates, codeRateCount, repaired, oled, pMessageNumber,
+                           findTurboCopy(deinterleaver.turboSequence(i)), &decodeStats);
+
+        // Increment the message counter for "P" type messages
+        pMessageNumber++;
+        reportStats();
+    }
+}
 
 /**
  * @brief Setup function executed once at the start of the program.
@@ -62,56 +194,111 @@ void setup() {
  *        Handles incoming LoRa data, processes messages, and performs decoding.
  */
 void loop() {
-    // Read incoming data from the LoRa module
-    String LoRaData = lora.receivePacket();
+    // Read incoming data from the LoRa module; packets with a bad header are already dropped
+    LoRaPacket::Header header;
+    const uint8_t* payload = lora.receivePacket(header);
 
-    // Check if any data was received
-    if (LoRaData.length() > 0) {
-        // Check if the received message starts with "P:!"
-        if (LoRaData.startsWith("P:!")) {
-            // Extract the payload by removing the "P:!" prefix
-            String payload = LoRaData.substring(3);
+    // The Turbo copy was lost, decode the held codeword on its own
+    if (pendingValid && millis() - pendingSince > PENDING_TIMEOUT_MS) {
+        decodePending(nullptr);
+    }
 
-            // Decode the message using Reed-Solomon and update OLED display
-            Utils::decodeMessage(payload.c_str(), rs, repaired, oled, pMessageNumber);
+    // Packets of the interleaved group were lost, decode what arrived
+    if (deinterleaver.pending() && millis() - deinterleaver.startedAt() > GROUP_TIMEOUT_MS) {
+        decodeGroup();
+    }
 
-            // Increment the message counter for "P" type messages
-            pMessageNumber++;
-        }
-        // Check if the received message starts with "W:!"
-        else if (LoRaData.startsWith("W:!")) {
-            // Extract the payload by removing the "W:!" prefix
-            String payload = LoRaData.substring(3);
+    // Check if any data was received
+    if (payload != nullptr) {
+        // A Reed-Solomon ("P") frame
+        if (header.type == LoRaPacket::TYPE_REED_SOLOMON) {
+            // A held codeword whose Turbo copy never came is decoded first
+            decodePending(nullptr);
 
-            // Validate the payload length to ensure it includes bit length information
-            if (payload.length() < sizeof(uint16_t)) {
+            // Hold the payload until its Turbo copy arrives
+            pendingPayload.assign((const char*)payload, header.length);
+            pendingValid = true;
+            pendingSince = millis();
+            pendingSequence = header.sequence;
+        }
+        // One packet of an interleaved group ("I")
+        else if (header.type == LoRaPacket::TYPE_INTERLEAVED) {
+            // A packet of the next group closes the current one
+            if (deinterleaver.startsNewGroup(payload, header.length)) {
+                decodeGroup();
+            }
+            if (!deinterleaver.addPacket(payload, header.length, header.sequence)) {
+                Serial.println("Error: Invalid interleaved packet.");
+            }
+            // A complete group still waits for the Turbo copy of its last frame, sent right after it
+        }
+        // The Turbo ("W") copy of the frame
+        else if (header.type == LoRaPacket::TYPE_TURBO) {
+            // Validate the payload length to ensure it includes the bit length and puncturing
+            const size_t fieldsSize = sizeof(uint16_t) + 1;
+            if (header.length < fieldsSize) {
                 Serial.println("Error: Payload too short for bit length.");
                 return; // Exit processing if payload is invalid
             }
 
-            // Extract the bit length from the payload
-            uint16_t bitLength;
-            memcpy(&bitLength, payload.c_str(), sizeof(uint16_t));
+            // Extract the bit length (little-endian) and the puncturing from the payload
+            uint16_t bitLength = payload[0] | payload[1] << 8;
+            uint8_t puncturing = payload[sizeof(uint16_t)];
+            if (puncturing >= TurboCodec::PUNCTURING_COUNT) {
+                Serial.println("Error: Unknown Turbo puncturing.");
+                return;
+            }
 
-            // Calculate the number of bytes required to store the message
+            // Calculate the number of bytes required to store the message,
+            // never reading past what actually arrived
             size_t byteCount = (bitLength + 7) / 8;
+            if (byteCount > header.length - fieldsSize) {
+                byteCount = header.length - fieldsSize;
+                bitLength = byteCount * 8;
+            }
 
             // Extract the byte message from the payload
-            std::vector<uint8_t> byteMessage(byteCount);
-            memcpy(byteMessage.data(), payload.c_str() + sizeof(uint16_t), byteCount);
+            std::vector<uint8_t> byteMessage(payload + fieldsSize, payload + fieldsSize + byteCount);
 
             // Convert the byte message into a bit-level representation
             std::vector<uint8_t> bitMessage;
             Utils::bytesToBits(byteMessage, bitLength, bitMessage);
 
-            // Print the received bit message to the Serial monitor for debugging
-            Serial.print("Received Bit Message #");
+            // Depuncture and decode the Turbo copy (iterative max-log-MAP over both constituent codes,
+            // stopped early once its CRC matches)
+            bool turboCrc;
+            std::string turboData = turboCodec.decode(bitMessage, (TurboCodec::Puncturing)puncturing,
+                                                      TurboCodec::DEFAULT_ITERATIONS, &turboCrc);
+
+            // Print the decoded Turbo message to the Serial monitor
+            Serial.print("Turbo Decoded Message #");
             Serial.print(wMessageNumber);
-            Serial.print("# : ");
-            for (uint8_t bit : bitMessage) {
-                Serial.print(bit);
+            Serial.print(turboCrc ? "# (CRC OK) : " : "# (CRC failed) : ");
+            // Only a verified copy may become the key frame of the following delta frames
+            char turboText[TelemetryFrame::TEXT_SIZE];
+            if (!turboCrc) {
+                Serial.println("not shown");
+            } else if (Utils::formatTelemetry(turboData.data(), turboData.size(), turboText, sizeof(turboText))) {
+                Serial.println(turboText);
+            } else {
+                Serial.println("not a telemetry frame or its key frame was lost");
+            }
+
+            // Use the decoded Turbo copy as erasure hints for the held Reed-Solomon codeword; a copy
+            // that failed its CRC still has wrong bytes and would only mark correct ones, and a copy
+            // of another frame (its own P and the held codeword's W were lost) would mark a whole frame
+            bool sameFrame = pendingValid && header.sequence == (uint16_t)(pendingSequence + 1);
+            decodePending(turboCrc && sameFrame ? &turboData : nullptr);
+
+            // Keep a verified copy for its interleaved frame; the first W packet after a complete group
+            // is the copy of its last frame, or shows that copy was lost
+            TurboCopy& copy = turboCopies[header.sequence % FrameDeinterleaver::MAX_DEPTH];
+            copy.valid = turboCrc;
+            copy.sequence = header.sequence;
+            copy.data = turboData;
+            if (deinterleaver.complete()) {
+                decodeGroup();
             }
-            Serial.println();
 
             // Increment the message counter for "W" type messages
             wMessageNumber++;
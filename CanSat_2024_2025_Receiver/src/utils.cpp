@@ -1,43 +1,193 @@
 #include "utils.hpp"
 
+TelemetryDecompressor Utils::telemetry;
+
 /**
- * @brief Decodes a Reed-Solomon encoded message.
- * @param payload The encoded payload to decode.
- * @param rs Reed-Solomon encoder/decoder instance.
+ * @brief Decodes a frame holding a shortened Reed-Solomon codeword.
+ * @param payload The encoded frame to decode.
+ * @param rates Table of code rates the sender can choose from.
+ * @param rateCount Number of entries in rates.
  * @param repaired Buffer for storing the repaired message.
  * @param oled Reference to the OLED handler for display updates.
  * @param messageNumber Identifier for the message being decoded.
+ * @param turboData Turbo-decoded copy of the same frame, or nullptr if it did not arrive.
+ * @return true if the message was decoded.
  */
-void Utils::decodeMessage(const std::string& payload, RS::ReedSolomon<96, 32>& rs, char* repaired, OLEDHandler& oled, int messageNumber) {
-    const int messageSize = 96;
-    const int ECC_LENGTH = 32;
-    char encodedMessage[messageSize + ECC_LENGTH];
+bool Utils::decodeMessage(const std::string& payload, const RS::CodeRate* rates, size_t rateCount, char* repaired,
+                          OLEDHandler& oled, int messageNumber, const std::string* turboData,
+                          DecodeStats* stats) {
+    // The packet header already checked the length, so the payload is exactly the frame
+    size_t frameLength = payload.length();
+    if (frameLength <= FRAME_HEADER_SIZE) {
+        Serial.println("Error: Frame too short for header.");
+        return false;
+    }
+
+    const uint8_t* frame = (const uint8_t*)payload.data();
+    return decodeFrame(frame, frame + FRAME_HEADER_SIZE, frameLength - FRAME_HEADER_SIZE, nullptr,
+                       rates, rateCount, repaired, oled, messageNumber, turboData, stats);
+}
 
-    if (payload.length() != (messageSize + ECC_LENGTH + 2)) {
-        Serial.println("Error: Invalid payload size for decoding.");
-        //return;
+/**
+ * @brief Decodes one frame given its header and codeword bytes.
+ * @param header The frame header.
+ * @param codeword The received codeword bytes.
+ * @param received Number of codeword bytes present.
+ * @param missing Mask of codeword bytes that did not arrive, or nullptr.
+ * @param rates Table of code rates the sender can choose from.
+ * @param rateCount Number of entries in rates.
+ * @param repaired Buffer for storing the repaired message.
+ * @param oled Reference to the OLED handler for display updates.
+ * @param messageNumber Identifier for the message being decoded.
+ * @param turboData Turbo-decoded copy of the same frame, or nullptr if it did not arrive.
+ * @return true if the message was decoded.
+ */
+bool Utils::decodeFrame(const uint8_t* header, const uint8_t* codeword, size_t received, const uint8_t* missing,
+                        const RS::CodeRate* rates, size_t rateCount, char* repaired,
+                        OLEDHandler& oled, int messageNumber, const std::string* turboData,
+                        DecodeStats* stats) {
+    // Header: message length, then the rate index with its complement in the high nibble
+    size_t messageLength = header[0];
+    uint8_t rateIndex = header[1] & 0x0F;
+    bool headerValid = (header[1] >> 4) == (~rateIndex & 0x0F) && rateIndex < rateCount &&
+                       messageLength > 0 && messageLength <= rates[rateIndex].msg_length;
+
+    bool decoded = false;
+    size_t eccLength = 0;
+    RS::DecodeResult result;
+    result.status = RS::RESULT_BAD_ARGUMENT;
+    if (headerValid) {
+        if (missing == nullptr && received != messageLength + rates[rateIndex].ecc_length) {
+            Serial.println("Error: Invalid payload size for decoding.");
+        }
+        eccLength = rates[rateIndex].ecc_length;
+        decoded = decodeCodeword(codeword, received, missing, rates[rateIndex], messageLength, repaired, turboData,
+                                 &result);
+    } else {
+        // Damaged header: try every code rate that fits the received length, strongest first.
+        // The codes are nested (a 16-byte ECC codeword is also an 8-byte one), so a weaker
+        // rate would accept a stronger frame with the wrong length
+        Serial.println("Error: Invalid frame header, inferring the code rate from the frame length.");
+        for (size_t i = rateCount; i-- > 0 && !decoded;) {
+            if (received <= rates[i].ecc_length || received - rates[i].ecc_length > rates[i].msg_length) {
+                continue;
+            }
+            messageLength = received - rates[i].ecc_length;
+            eccLength = rates[i].ecc_length;
+            decoded = decodeCodeword(codeword, received, missing, rates[i], messageLength, repaired, turboData,
+                                     &result) &&
+                      isTelemetryMessage(repaired, messageLength);
+        }
     }
 
-    // Copy the payload into the encoded message buffer
-    for (int i = 0; i < messageSize + ECC_LENGTH; i++) {
-        encodedMessage[i] = payload[i];
+    if (stats != nullptr) {
+        if (!decoded) {
+            result.status = RS::RESULT_LOCATOR_FAILED;
+        }
+        stats->record(result, messageLength + eccLength);
     }
 
-    // Decode the message using Reed-Solomon
-    rs.Decode(encodedMessage, repaired);
+    if (!decoded) {
+        Serial.print("Error: Reed-Solomon decoding failed for message ");
+        Serial.println(messageNumber);
+        return false;
+    }
+
+    // A frame of another layout decodes fine but cannot be read, a delta frame needs its key frame
+    char text[TelemetryFrame::TEXT_SIZE];
+    uint32_t pressurePa = 0;
+    if (!formatTelemetry(repaired, messageLength, text, sizeof(text), &pressurePa)) {
+        if (TelemetryDecompressor::frameLength((const uint8_t*)repaired, messageLength) > 0) {
+            Serial.print("Error: Key frame lost, waiting for the next one to restore message ");
+        } else {
+            Serial.print("Error: Unknown telemetry frame version ");
+            Serial.print((uint8_t)repaired[0]);
+            Serial.print(" in message ");
+        }
+        Serial.println(messageNumber);
+        return false;
+    }
 
     // Print the decoded message to the Serial monitor
     Serial.print("Reed-Solomon Decoded Message: ");
     Serial.print(messageNumber);
     Serial.print(", ");
-    for (int i = 0; i < messageSize; i++) {
-        Serial.print(repaired[i]);
+    Serial.println(text);
+    printPressureBatch(repaired, messageLength, pressurePa, messageNumber);
+
+    // Corrected symbols of this frame, an early sign of the link margin
+    if (result.corrected || result.erasures > 0) {
+        Serial.print("Reed-Solomon Corrected: ");
+        Serial.print(result.erasures);
+        Serial.print(" erasures, ");
+        Serial.print(result.errors);
+        Serial.print(" errors at");
+        uint8_t positions = RS::ResultPositions(&result);
+        for (uint8_t i = 0; i < positions; i++) {
+            Serial.print(" ");
+            Serial.print(result.positions[i]);
+        }
+        Serial.println();
     }
-    Serial.println();
 
     // Update the OLED display with the decoded message
     int rssi = -75; // Example RSSI value
-    updateOLED(oled, std::string(repaired, messageSize), rssi);
+    updateOLED(oled, text, rssi);
+    return true;
+}
+
+/**
+ * @brief Decodes one codeword, using erasure hints from the link checks.
+ * @param codeword The received codeword bytes.
+ * @param received Number of codeword bytes that arrived.
+ * @param missing Mask of codeword bytes that did not arrive, or nullptr.
+ * @param rate Code rate of the codeword.
+ * @param messageLength Message length of the shortened codeword.
+ * @param repaired Buffer for storing the repaired message.
+ * @param turboData Turbo-decoded copy of the same frame, or nullptr.
+ * @param result Filled with the corrected symbols of the last decode attempt.
+ * @return true if the codeword was decoded.
+ */
+bool Utils::decodeCodeword(const uint8_t* codeword, size_t received, const uint8_t* missing, const RS::CodeRate& rate,
+                           size_t messageLength, char* repaired, const std::string* turboData,
+                           RS::DecodeResult* result) {
+    char encodedMessage[ErasureHints::MAX_CODEWORD_LEN];
+    size_t codewordLength = messageLength + rate.ecc_length;
+
+    // Copy the codeword into the encoded message buffer, missing bytes stay zero
+    if (received > codewordLength) {
+        received = codewordLength;
+    }
+    memset(encodedMessage, 0, sizeof(encodedMessage));
+    memcpy(encodedMessage, codeword, received);
+
+    // Collect erasure hints, most reliable first
+    ErasureHints hints(messageLength, rate.ecc_length);
+    hints.markTruncated(received);
+    if (missing != nullptr) {
+        hints.markMissing(missing, received);
+    }
+    if (turboData != nullptr) {
+        hints.markTurboDisagreement(encodedMessage, *turboData);
+    }
+    hints.markFraming(encodedMessage);
+
+    // Decode the message using Reed-Solomon, with the hints as erasures
+    size_t eraseCount = hints.count();
+    int status = rate.decode(encodedMessage, messageLength, repaired, hints.positions(), eraseCount, result);
+
+    // A wrong hint wastes correction capacity, so retry with the missing bytes only
+    if (status != 0) {
+        hints.reset(messageLength, rate.ecc_length);
+        hints.markTruncated(received);
+        if (missing != nullptr) {
+            hints.markMissing(missing, received);
+        }
+        if (hints.count() < eraseCount) {
+            status = rate.decode(encodedMessage, messageLength, repaired, hints.positions(), hints.count(), result);
+        }
+    }
+    return status == 0;
 }
 
 /**
@@ -55,6 +205,83 @@ void Utils::updateOLED(OLEDHandler& oled, const std::string& text, int rssi) {
     oled.display();
 }
 
+/**
+ * @brief Restores the key or delta telemetry frame of a message and formats it as the CSV line the sender logs.
+ * @param data The message.
+ * @param length Length of the message in bytes.
+ * @param text Buffer for the CSV line.
+ * @param textSize Size of the text buffer.
+ * @param pressurePa Set to the pressure field of the restored frame in Pa, or nullptr.
+ * @return true if the frame was restored.
+ */
+bool Utils::formatTelemetry(const char* data, size_t length, char* text, size_t textSize, uint32_t* pressurePa) {
+    uint8_t frame[TelemetryFrame::SIZE];
+    Telemetry sample;
+    size_t frameLength = TelemetryDecompressor::frameLength((const uint8_t*)data, length);
+    if (frameLength == 0 || !telemetry.decompress((const uint8_t*)data, frameLength, frame) ||
+        !TelemetryFrame::parse(frame, sizeof(frame), sample)) {
+        return false;
+    }
+    TelemetryFrame::format(sample, text, textSize);
+    if (pressurePa != nullptr) {
+        *pressurePa = TelemetryFrame::pressureField(frame);
+    }
+    return true;
+}
+
+/**
+ * @brief Checks the shape of a message: a telemetry frame, alone or followed by a valid pressure batch.
+ * @param data The message.
+ * @param length Length of the message in bytes.
+ * @return true if the message has the shape of a telemetry message.
+ */
+bool Utils::isTelemetryMessage(const char* data, size_t length) {
+    size_t frameLength = TelemetryDecompressor::frameLength((const uint8_t*)data, length);
+    if (frameLength == 0 || frameLength == length) {
+        return frameLength > 0;
+    }
+    uint8_t periodMs;
+    uint16_t ageMs;
+    return PressureBatch::decode((const uint8_t*)data + frameLength, length - frameLength, 0, nullptr, 0,
+                                 periodMs, ageMs) > 0;
+}
+
+/**
+ * @brief Prints the pressure batch after the telemetry frame of a message as one "PRESSURE:" line.
+ * @param data The message.
+ * @param length Length of the message in bytes.
+ * @param referencePa Pressure field of the restored frame in Pa.
+ * @param messageNumber The message number for logging.
+ */
+void Utils::printPressureBatch(const char* data, size_t length, uint32_t referencePa, int messageNumber) {
+    size_t frameLength = TelemetryDecompressor::frameLength((const uint8_t*)data, length);
+    if (frameLength == 0 || frameLength == length) {
+        return;
+    }
+
+    // Every sample takes at least one byte, so a message never holds more than MAX_MSG_LEN
+    PressureBatch::Sample samples[ErasureHints::MAX_MSG_LEN];
+    uint8_t periodMs;
+    uint16_t ageMs;
+    size_t count = PressureBatch::decode((const uint8_t*)data + frameLength, length - frameLength, referencePa,
+                                         samples, ErasureHints::MAX_MSG_LEN, periodMs, ageMs);
+    if (count == 0) {
+        Serial.print("Error: Invalid pressure batch in message ");
+        Serial.println(messageNumber);
+        return;
+    }
+
+    Serial.print("PRESSURE:");
+    Serial.print(messageNumber);
+    for (size_t i = 0; i < count; i++) {
+        Serial.print(",");
+        Serial.print((long)samples[i].slot * periodMs - ageMs);
+        Serial.print("/");
+        Serial.print(samples[i].pressure);
+    }
+    Serial.println();
+}
+
 /**
  * @brief Converts a byte array into a bit array.
  * @param bytes The byte array to convert.
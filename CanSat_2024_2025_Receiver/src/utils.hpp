@@ -4,6 +4,14 @@
 #include <Arduino.h>
 #include <RS-FEC.h>
 #include <OLEDHandler.hpp>
+#include "ErasureHints.hpp"
+#include "DecodeStats.hpp"
+#include <TelemetryFrame.h>
+#include <TelemetryCompressor.h>
+#include <PressureBatch.h>
+
+// Frame header in front of every Reed-Solomon codeword: message length and code rate index
+#define FRAME_HEADER_SIZE 2
 #include <vector>
 #include <string>
 
@@ -14,14 +22,40 @@
 class Utils {
 public:
     /**
-     * @brief Decodes a Reed-Solomon encoded message.
-     * @param payload The encoded payload to decode.
-     * @param rs Reed-Solomon encoder/decoder instance.
+     * @brief Decodes a frame holding a shortened Reed-Solomon codeword.
+     * @param payload The encoded frame to decode (header, message, ECC).
+     * @param rates Table of code rates the sender can choose from.
+     * @param rateCount Number of entries in rates.
      * @param repaired Buffer for storing the repaired message.
      * @param oled Reference to the OLED handler for display updates.
      * @param messageNumber Identifier for the message being decoded.
+     * @param turboData Turbo-decoded copy of the same frame, or nullptr if it did not arrive.
+     * @param stats Decode statistics the frame result is added to, or nullptr.
+     * @return true if the message was decoded.
      */
-    static void decodeMessage(const std::string& payload, RS::ReedSolomon<96, 32>& rs, char* repaired, OLEDHandler& oled, int messageNumber);
+    static bool decodeMessage(const std::string& payload, const RS::CodeRate* rates, size_t rateCount, char* repaired,
+                              OLEDHandler& oled, int messageNumber, const std::string* turboData = nullptr,
+                              DecodeStats* stats = nullptr);
+
+    /**
+     * @brief Decodes one frame given its header and codeword bytes.
+     * @param header The frame header (FRAME_HEADER_SIZE bytes).
+     * @param codeword The received codeword bytes.
+     * @param received Number of codeword bytes present.
+     * @param missing Mask of codeword bytes that did not arrive (received entries), or nullptr.
+     * @param rates Table of code rates the sender can choose from.
+     * @param rateCount Number of entries in rates.
+     * @param repaired Buffer for storing the repaired message.
+     * @param oled Reference to the OLED handler for display updates.
+     * @param messageNumber Identifier for the message being decoded.
+     * @param turboData Turbo-decoded copy of the same frame, or nullptr if it did not arrive.
+     * @param stats Decode statistics the frame result is added to, or nullptr.
+     * @return true if the message was decoded.
+     */
+    static bool decodeFrame(const uint8_t* header, const uint8_t* codeword, size_t received, const uint8_t* missing,
+                            const RS::CodeRate* rates, size_t rateCount, char* repaired,
+                            OLEDHandler& oled, int messageNumber, const std::string* turboData = nullptr,
+                            DecodeStats* stats = nullptr);
 
     /**
      * @brief Updates the OLED display with decoded message details.
@@ -31,6 +65,39 @@ public:
      */
     static void updateOLED(OLEDHandler& oled, const std::string& text, int rssi);
 
+    /**
+     * @brief Restores the key or delta telemetry frame of a message and formats it as the CSV line the sender logs.
+     *        Key frames update the reference of the following delta frames, so only pass
+     *        data that passed its error correction or CRC.
+     * @param data The message, a key or delta telemetry frame and an optional pressure batch.
+     * @param length Length of the message in bytes.
+     * @param text Buffer for the CSV line, TelemetryFrame::TEXT_SIZE bytes hold every line.
+     * @param textSize Size of the text buffer.
+     * @param pressurePa Set to the pressure field of the restored frame in Pa, the reference of the batch, or nullptr.
+     * @return true if the frame was restored, false for an unknown frame or a delta frame whose key frame was lost.
+     */
+    static bool formatTelemetry(const char* data, size_t length, char* text, size_t textSize,
+                                uint32_t* pressurePa = nullptr);
+
+    /**
+     * @brief Checks the shape of a message: a key or delta telemetry frame, alone or followed by a valid pressure batch.
+     * @param data The message.
+     * @param length Length of the message in bytes.
+     * @return true if the message has the shape of a telemetry message.
+     */
+    static bool isTelemetryMessage(const char* data, size_t length);
+
+    /**
+     * @brief Prints the pressure batch after the telemetry frame of a message as one "PRESSURE:" line.
+     *        Format: message number, then one "ms/Pa" pair per sample, ms counting back from the frame.
+     *        Prints nothing if the message has no batch.
+     * @param data The message.
+     * @param length Length of the message in bytes.
+     * @param referencePa Pressure field of the restored frame in Pa, filled by formatTelemetry.
+     * @param messageNumber The message number for logging.
+     */
+    static void printPressureBatch(const char* data, size_t length, uint32_t referencePa, int messageNumber);
+
     /**
      * @brief Converts a byte array into a bit array.
      * @param bytes The byte array to convert.
@@ -38,6 +105,25 @@ public:
      * @param bits The resulting bit array.
      */
     static void bytesToBits(const std::vector<uint8_t>& bytes, uint16_t bitLength, std::vector<uint8_t>& bits);
+
+private:
+    static TelemetryDecompressor telemetry; ///< Last key frame, the reference of the delta frames
+
+    /**
+     * @brief Decodes one codeword, using erasure hints from the link checks.
+     * @param codeword The received codeword bytes.
+     * @param received Number of codeword bytes that arrived.
+     * @param missing Mask of codeword bytes that did not arrive, or nullptr.
+     * @param rate Code rate of the codeword.
+     * @param messageLength Message length of the shortened codeword.
+     * @param repaired Buffer for storing the repaired message.
+     * @param turboData Turbo-decoded copy of the same frame, or nullptr.
+     * @param result Filled with the corrected symbols of the last decode attempt.
+     * @return true if the codeword was decoded.
+     */
+    static bool decodeCodeword(const uint8_t* codeword, size_t received, const uint8_t* missing, const RS::CodeRate& rate,
+                               size_t messageLength, char* repaired, const std::string* turboData,
+                               RS::DecodeResult* result);
 };
 
 #endif // UTILS_HPP
@@ -0,0 +1,344 @@
+/* Host benchmark for the RS-FEC GF(256) kernels.
+ *
+ * Build and run from this directory:
+ *   g++ -O2 -DNDEBUG -mavx2 -pthread -I../../src fec_benchmark.cpp -o fec_benchmark && ./fec_benchmark
+ * Drop -mavx2 (or use -mssse3) to compare the narrower SIMD paths.
+ * Add -fsanitize=thread to check the shared-codec decoding for data races. */
+
+#include "RS-FEC.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const uint8_t MSG_LEN = 96;
+static const uint8_t ECC_LEN = 32;
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double elapsed_ns(bench_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+}
+
+/* Scalar reference: the per-symbol gf::mul loop EncodeBlock used before the region kernel */
+static void encode_scalar(const uint8_t* gen, const uint8_t* msg, uint8_t* ecc) {
+    uint8_t out[MSG_LEN + ECC_LEN] = {0};
+    memcpy(out, msg, MSG_LEN);
+    for(uint8_t i = 0; i < MSG_LEN; i++) {
+        uint8_t coef = out[i];
+        if(coef != 0) {
+            for(uint8_t j = 1; j < ECC_LEN + 1; j++) {
+                out[i+j] ^= RS::gf::mul(gen[j], coef);
+            }
+        }
+    }
+    memcpy(ecc, out + MSG_LEN, ECC_LEN);
+}
+
+static void bench_region(size_t len, int rounds) {
+    uint8_t* src = new uint8_t[len];
+    uint8_t* dst = new uint8_t[len];
+    for(size_t i = 0; i < len; i++) { src[i] = rand(); dst[i] = rand(); }
+
+    bench_clock::time_point t = bench_clock::now();
+    for(int r = 0; r < rounds; r++) {
+        uint8_t c = (uint8_t)(r | 2);
+        for(size_t i = 0; i < len; i++) dst[i] ^= RS::gf::mul(src[i], c);
+    }
+    double scalar_ns = elapsed_ns(t) / rounds;
+
+    t = bench_clock::now();
+    for(int r = 0; r < rounds; r++) {
+        RS::gf::mul_add_region(dst, src, (uint8_t)(r | 2), len);
+    }
+    double region_ns = elapsed_ns(t) / rounds;
+
+    printf("mul_add_region %5zu B: scalar %9.1f ns  kernel %9.1f ns  speedup %5.2fx  (sink %u)\n",
+           len, scalar_ns, region_ns, scalar_ns / region_ns, dst[len / 2]);
+    delete[] src;
+    delete[] dst;
+}
+
+/* Per-root Horner evaluation, the syndrome loop Decode used before the all-roots pass */
+static uint8_t syndromes_horner(const uint8_t* cw, uint8_t* synd) {
+    uint8_t any = 0;
+    for(uint8_t r = 0; r < ECC_LEN; r++) {
+        uint8_t x = RS::gf::pow(2, r);
+        uint8_t y = cw[0];
+        for(uint8_t k = 1; k < MSG_LEN + ECC_LEN; k++) y = RS::gf::mul(y, x) ^ cw[k];
+        synd[r] = y;
+        any |= y;
+    }
+    return any;
+}
+
+/* A clean codeword costs Decode one syndrome pass plus the message copy */
+static void bench_clean_decode(int rounds) {
+    RS::ReedSolomon<MSG_LEN, ECC_LEN> rs;
+    uint8_t cw[MSG_LEN + ECC_LEN], out[MSG_LEN], synd[ECC_LEN];
+    for(uint8_t i = 0; i < MSG_LEN; i++) cw[i] = rand();
+    rs.Encode(cw, cw);
+
+    bench_clock::time_point t = bench_clock::now();
+    uint8_t sink = 0;
+    for(int r = 0; r < rounds; r++) sink |= syndromes_horner(cw, synd);
+    double horner_ns = elapsed_ns(t) / rounds;
+
+    t = bench_clock::now();
+    for(int r = 0; r < rounds; r++) sink |= rs.Decode(cw, out);
+    double decode_ns = elapsed_ns(t) / rounds;
+
+    printf("Clean codeword: per-root syndromes %8.1f ns  Decode (all roots + exit) %8.1f ns  speedup %5.2fx  (sink %u)\n",
+           horner_ns, decode_ns, horner_ns / decode_ns, sink);
+}
+
+/* Recorded-flight style workload: mostly clean codewords, some with up to t errors */
+static void bench_batch(size_t n) {
+    const size_t cw_len = MSG_LEN + ECC_LEN;
+    RS::ReedSolomon<MSG_LEN, ECC_LEN> rs;
+    std::vector<uint8_t> in(n * cw_len), out(n * MSG_LEN);
+    std::vector<RS::DecodeResult> results(n);
+
+    for(size_t i = 0; i < n; i++) {
+        uint8_t* cw = &in[i * cw_len];
+        for(uint8_t j = 0; j < MSG_LEN; j++) cw[j] = rand();
+        rs.Encode(cw, cw);
+        if(i % 10 == 0) {
+            int errors = 1 + rand() % (ECC_LEN / 2);
+            for(int e = 0; e < errors; e++) cw[rand() % cw_len] ^= 1 + rand() % 255;
+        }
+    }
+
+    bench_clock::time_point t = bench_clock::now();
+    size_t failed_single = 0;
+    for(size_t i = 0; i < n; i++) {
+        if(rs.Decode(&in[i * cw_len], &out[i * MSG_LEN]) != 0) failed_single++;
+    }
+    double single_ns = elapsed_ns(t) / n;
+
+    t = bench_clock::now();
+    size_t failed_batch = rs.DecodeBatch(in.data(), out.data(), n, results.data());
+    double batch_ns = elapsed_ns(t) / n;
+
+    printf("Decode x%zu: per call %8.1f ns  DecodeBatch %8.1f ns  (failed %zu/%zu)\n",
+           n, single_ns, batch_ns, failed_single, failed_batch);
+
+    /* Threaded batches of growing size against the calling thread alone. DecodeBatch
+     * takes at most one thread per core and RS_BATCH_MIN_PER_THREAD codewords each,
+     * so below that, or on one core, both columns time the same single-thread decode */
+    const unsigned cores = std::thread::hardware_concurrency();
+    const unsigned threads = cores < 2 ? 2 : cores;
+    std::vector<uint8_t> out_threads(n * MSG_LEN);
+    const size_t sizes[] = {64, 256, 1024, 4096, n};
+    for(size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        const size_t batch = sizes[s] < n ? sizes[s] : n;
+        const int reps = (int)(4 * n / batch);
+        rs.DecodeBatch(in.data(), out_threads.data(), batch, NULL, threads); // starts the pool workers
+
+        t = bench_clock::now();
+        for(int r = 0; r < reps; r++) rs.DecodeBatch(in.data(), out.data(), batch);
+        double one_ns = elapsed_ns(t) / (reps * batch);
+
+        t = bench_clock::now();
+        size_t failed_threads = 0;
+        for(int r = 0; r < reps; r++) failed_threads = rs.DecodeBatch(in.data(), out_threads.data(), batch, NULL, threads);
+        double many_ns = elapsed_ns(t) / (reps * batch);
+
+        const bool same = memcmp(out.data(), out_threads.data(), batch * MSG_LEN) == 0;
+        printf("DecodeBatch x%5zu: 1 thread %7.1f ns  %u threads (%u cores) %7.1f ns  speedup %5.2fx  (failed %zu, %s)\n",
+               batch, one_ns, threads, cores, many_ns, one_ns / many_ns, failed_threads,
+               same ? "same output" : "OUTPUT DIFFERS");
+    }
+}
+
+/* Many threads share one codec and decode at the same time; every output must match
+ * the single-threaded decode of the same codeword */
+static bool check_shared_codec(size_t n, int passes) {
+    const size_t cw_len = MSG_LEN + ECC_LEN;
+    RS::ReedSolomon<MSG_LEN, ECC_LEN> rs;
+    std::vector<uint8_t> in(n * cw_len), ref(n * MSG_LEN);
+    std::vector<int> ref_status(n);
+
+    for(size_t i = 0; i < n; i++) {
+        uint8_t* cw = &in[i * cw_len];
+        for(uint8_t j = 0; j < MSG_LEN; j++) cw[j] = rand();
+        rs.Encode(cw, cw);
+        int errors = rand() % (ECC_LEN / 2 + 4);
+        for(int e = 0; e < errors; e++) cw[rand() % cw_len] ^= 1 + rand() % 255;
+        ref_status[i] = rs.Decode(cw, &ref[i * MSG_LEN]);
+    }
+
+    unsigned threads = std::thread::hardware_concurrency();
+    if(threads < 4) threads = 4;
+    std::vector<size_t> mismatches(threads, 0);
+    std::vector<std::thread> workers;
+
+    bench_clock::time_point t = bench_clock::now();
+    for(unsigned w = 0; w < threads; w++) {
+        workers.push_back(std::thread([&, w]() {
+            uint8_t out[MSG_LEN];
+            RS::DecodeResult result;
+            for(int p = 0; p < passes; p++) {
+                /* every thread walks the codewords from its own offset, so they collide on the codec */
+                for(size_t k = 0; k < n; k++) {
+                    const size_t i = (k + w * n / threads) % n;
+                    int status = (k & 1) ? rs.Decode(&in[i * cw_len], out, NULL, 0, &result)
+                                         : rs.DecodeShortened(&in[i * cw_len], MSG_LEN, out);
+                    if(status != ref_status[i] || (status == 0 && memcmp(out, &ref[i * MSG_LEN], MSG_LEN) != 0))
+                        mismatches[w]++;
+                }
+            }
+        }));
+    }
+
+    size_t mismatched = 0;
+    for(unsigned w = 0; w < threads; w++) {
+        workers[w].join();
+        mismatched += mismatches[w];
+    }
+    double ns = elapsed_ns(t) / (n * passes * threads);
+
+    printf("Shared codec, %u threads x %zu decodes: %8.1f ns per decode  (mismatches %zu)\n",
+           threads, n * passes, ns, mismatched);
+    return mismatched == 0;
+}
+
+/* Worst case for the locator stage: t = ECC_LEN/2 symbol errors in every codeword */
+static void bench_cores(int rounds) {
+    const size_t cw_len = MSG_LEN + ECC_LEN;
+    RS::ReedSolomon<MSG_LEN, ECC_LEN> rs;
+    std::vector<uint8_t> in(rounds * cw_len);
+    uint8_t out[MSG_LEN];
+
+    for(int i = 0; i < rounds; i++) {
+        uint8_t* cw = &in[i * cw_len];
+        for(uint8_t j = 0; j < MSG_LEN; j++) cw[j] = rand();
+        rs.Encode(cw, cw);
+        /* distinct positions so exactly t symbols are wrong */
+        for(int e = 0; e < ECC_LEN / 2; e++) cw[e * (cw_len / (ECC_LEN / 2)) + rand() % (cw_len / (ECC_LEN / 2))] ^= 1 + rand() % 255;
+    }
+
+    double ns[2];
+    size_t failed[2];
+    const RS::DecoderCore cores[2] = { RS::CORE_POLY, RS::CORE_TABLE };
+    for(int c = 0; c < 2; c++) {
+        rs.SetDecoderCore(cores[c]);
+        failed[c] = 0;
+        bench_clock::time_point t = bench_clock::now();
+        for(int i = 0; i < rounds; i++) {
+            if(rs.Decode(&in[i * cw_len], out) != 0) failed[c]++;
+        }
+        ns[c] = elapsed_ns(t) / rounds;
+    }
+
+    printf("Decode with t=%u errors: CORE_POLY %9.1f ns  CORE_TABLE %9.1f ns  speedup %5.2fx  (failed %zu/%zu)\n",
+           ECC_LEN / 2, ns[0], ns[1], ns[0] / ns[1], failed[0], failed[1]);
+}
+
+/* Outcome of both cores on the same corrupted codewords: corrected, rejected, or
+ * accepted with wrong data. Inside the capacity 2*errors + erasures <= ECC_LEN
+ * a decoder should correct everything; past it, every accepted word is a miscorrection */
+static void compare_cores(int rounds) {
+    const size_t cw_len = MSG_LEN + ECC_LEN;
+    const int cases[][2] = {   /* errors, erasures */
+        { ECC_LEN / 2,     0 },
+        { 0,               ECC_LEN },
+        { ECC_LEN / 4,     ECC_LEN / 2 },
+        { ECC_LEN / 2 + 1, 0 },
+        { 2,               ECC_LEN - 2 },
+        { 1,               ECC_LEN },
+    };
+    const RS::DecoderCore cores[2] = { RS::CORE_POLY, RS::CORE_TABLE };
+    RS::ReedSolomon<MSG_LEN, ECC_LEN> rs;
+    uint8_t msg[MSG_LEN], cw[cw_len], out[MSG_LEN], pos[ECC_LEN];
+
+    for(size_t k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+        const int errors = cases[k][0], erasures = cases[k][1];
+        size_t ok[2] = {0, 0}, rejected[2] = {0, 0}, wrong[2] = {0, 0};
+
+        for(int r = 0; r < rounds; r++) {
+            for(uint8_t i = 0; i < MSG_LEN; i++) msg[i] = rand();
+            rs.Encode(msg, cw);
+
+            /* distinct positions, the first ones are reported as erasures */
+            bool used[cw_len] = {};
+            for(int n = 0; n < errors + erasures; ) {
+                const uint8_t p = rand() % cw_len;
+                if(used[p]) continue;
+                used[p] = true;
+                cw[p] ^= 1 + rand() % 255;
+                if(n < erasures) pos[n] = p;
+                n++;
+            }
+
+            for(int c = 0; c < 2; c++) {
+                rs.SetDecoderCore(cores[c]);
+                if(rs.Decode(cw, out, erasures ? pos : NULL, erasures) != 0) rejected[c]++;
+                else if(memcmp(out, msg, MSG_LEN) != 0) wrong[c]++;
+                else ok[c]++;
+            }
+        }
+
+        printf("%2d errors + %2d erasures (%s): CORE_POLY ok %5zu rejected %5zu wrong %5zu"
+               "  CORE_TABLE ok %5zu rejected %5zu wrong %5zu\n",
+               errors, erasures, 2 * errors + erasures <= ECC_LEN ? "inside" : "past  ",
+               ok[0], rejected[0], wrong[0], ok[1], rejected[1], wrong[1]);
+    }
+}
+
+int main() {
+    srand(1);
+#if defined(__AVX2__)
+    printf("GF region kernel: AVX2\n");
+#elif defined(RS_GF_SIMD)
+    printf("GF region kernel: SSSE3\n");
+#else
+    printf("GF region kernel: scalar tables\n");
+#endif
+
+    bench_region(32, 200000);
+    bench_region(128, 100000);
+    bench_region(4096, 5000);
+
+    const uint8_t* gen = RS::GeneratorTable<ECC_LEN>::poly.coef;
+
+    const int frames = 20000;
+    RS::ReedSolomon<MSG_LEN, ECC_LEN> rs;
+    uint8_t msg[MSG_LEN], ecc_ref[ECC_LEN], ecc[ECC_LEN];
+    for(uint8_t i = 0; i < MSG_LEN; i++) msg[i] = rand();
+
+    encode_scalar(gen, msg, ecc_ref);
+    rs.EncodeBlock(msg, ecc);
+    if(memcmp(ecc, ecc_ref, ECC_LEN) != 0) {
+        printf("EncodeBlock output differs from the scalar reference!\n");
+        return 1;
+    }
+
+    bench_clock::time_point t = bench_clock::now();
+    for(int f = 0; f < frames; f++) {
+        msg[f % MSG_LEN]++;
+        encode_scalar(gen, msg, ecc_ref);
+    }
+    double scalar_ns = elapsed_ns(t) / frames;
+
+    t = bench_clock::now();
+    for(int f = 0; f < frames; f++) {
+        msg[f % MSG_LEN]++;
+        rs.EncodeBlock(msg, ecc);
+    }
+    double kernel_ns = elapsed_ns(t) / frames;
+
+    printf("EncodeBlock<%u,%u>: scalar %9.1f ns  kernel %9.1f ns  speedup %5.2fx  (sink %u)\n",
+           MSG_LEN, ECC_LEN, scalar_ns, kernel_ns, scalar_ns / kernel_ns, ecc[0] ^ ecc_ref[0]);
+
+    bench_clean_decode(20000);
+    bench_batch(20000);
+    bench_cores(20000);
+    compare_cores(2000);
+
+    if(!check_shared_codec(2000, 5)) {
+        printf("Concurrent decoding differs from the single-threaded decode!\n");
+        return 1;
+    }
+    return 0;
+}
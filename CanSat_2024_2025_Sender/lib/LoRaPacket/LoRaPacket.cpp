@@ -0,0 +1,35 @@
+#include "LoRaPacket.h"
+
+uint8_t LoRaPacket::crc8(const uint8_t *data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+void LoRaPacket::writeHeader(const Header &header, uint8_t *out) {
+    out[0] = (uint8_t)(VERSION << 4 | (header.type & 0x0F));
+    out[1] = (uint8_t)header.sequence;
+    out[2] = (uint8_t)(header.sequence >> 8);
+    out[3] = header.length;
+    out[4] = crc8(out, HEADER_SIZE - 1);
+}
+
+bool LoRaPacket::parse(const uint8_t *packet, size_t length, Header &header) {
+    if (length < HEADER_SIZE || length > MAX_PACKET || crc8(packet, HEADER_SIZE - 1) != packet[4]) {
+        return false;
+    }
+    uint8_t type = packet[0] & 0x0F;
+    if ((packet[0] >> 4) != VERSION || type < TYPE_REED_SOLOMON || type > TYPE_INTERLEAVED ||
+        packet[3] != length - HEADER_SIZE) {
+        return false;
+    }
+    header.type = (Type)type;
+    header.sequence = (uint16_t)(packet[1] | packet[2] << 8);
+    header.length = packet[3];
+    return true;
+}
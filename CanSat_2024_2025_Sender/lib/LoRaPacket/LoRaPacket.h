@@ -0,0 +1,46 @@
+#ifndef LORA_PACKET_H
+#define LORA_PACKET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary header in front of every LoRa packet, shared by the sender and the receiver:
+//   offset size field
+//    0     1   version in the high nibble, packet type in the low nibble
+//    1     2   sequence number, little-endian, one counter over all packet types
+//    3     1   payload length
+//    4     1   CRC-8 of bytes 0-3
+// A damaged or foreign packet fails a CRC-8 over four bytes and a few compares, before any FEC work;
+// the payload itself is protected by its own Reed-Solomon or Turbo code
+class LoRaPacket {
+public:
+    static constexpr uint8_t VERSION = 1;        // Layout of this header
+    static constexpr size_t HEADER_SIZE = 5;     // Header bytes in front of the payload
+    static constexpr size_t MAX_PACKET = 255;    // Largest LoRa packet
+    static constexpr size_t MAX_PAYLOAD = MAX_PACKET - HEADER_SIZE; // Largest payload
+
+    // Packet types, the former "P:!", "W:!" and "I:!" prefixes
+    enum Type : uint8_t {
+        TYPE_REED_SOLOMON = 1, // One Reed-Solomon frame
+        TYPE_TURBO = 2,        // Turbo copy of the same frame: bit length, puncturing, coded bytes
+        TYPE_INTERLEAVED = 3,  // One packet of an interleaved frame group
+    };
+
+    struct Header {
+        Type type;          // Packet type
+        uint16_t sequence;  // Sequence number of the packet
+        uint8_t length;     // Payload length
+    };
+
+    // Writes the HEADER_SIZE header bytes of a packet to out
+    static void writeHeader(const Header &header, uint8_t *out);
+
+    // Checks and reads the header of a received packet. False unless the CRC, version and type are
+    // valid and the payload length matches the packet length exactly
+    static bool parse(const uint8_t *packet, size_t length, Header &header);
+
+    // CRC-8 (polynomial 0x07, init 0x00) of the header fields
+    static uint8_t crc8(const uint8_t *data, size_t length);
+};
+
+#endif // LORA_PACKET_H
@@ -0,0 +1,149 @@
+/* Host round-trip and rejection checks for the LoRaPacket header, not an Arduino sketch.
+ * It sits under examples/ so the firmware build leaves it out.
+ *
+ * Build and run from this directory:
+ *   g++ -O1 -g -fsanitize=address,undefined -I../.. lora_packet_test.cpp ../../LoRaPacket.cpp \
+ *       -o lora_packet_test && ./lora_packet_test
+ * Exits non-zero if a check fails. */
+
+#include "LoRaPacket.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+static int failures = 0;
+static std::mt19937 rng(1);
+
+static void check(bool ok, const char *name, int round) {
+    if (!ok) {
+        printf("FAIL %s (round %d)\n", name, round);
+        failures++;
+    }
+}
+
+// A packet of the given header and a random payload of header.length bytes, returns its length
+static size_t buildPacket(const LoRaPacket::Header &header, uint8_t *packet) {
+    LoRaPacket::writeHeader(header, packet);
+    for (size_t i = 0; i < header.length; i++) packet[LoRaPacket::HEADER_SIZE + i] = (uint8_t)rng();
+    return LoRaPacket::HEADER_SIZE + header.length;
+}
+
+// Same header fields back for every type, sequence number and payload length
+static void checkRoundTrip() {
+    static const LoRaPacket::Type TYPES[] = {LoRaPacket::TYPE_REED_SOLOMON, LoRaPacket::TYPE_TURBO,
+                                             LoRaPacket::TYPE_INTERLEAVED};
+    static const uint16_t SEQUENCES[] = {0, 1, 0x00FF, 0x0100, 0x1234, 0xFFFF};
+    static const uint8_t LENGTHS[] = {0, 1, 108, LoRaPacket::MAX_PAYLOAD};
+    int round = 0;
+    for (LoRaPacket::Type type : TYPES) {
+        for (uint16_t sequence : SEQUENCES) {
+            for (uint8_t length : LENGTHS) {
+                uint8_t packet[LoRaPacket::MAX_PACKET];
+                LoRaPacket::Header sent = {type, sequence, length}, received = {};
+                size_t size = buildPacket(sent, packet);
+                check(LoRaPacket::parse(packet, size, received) && received.type == type &&
+                          received.sequence == sequence && received.length == length,
+                      "header round trip", round);
+                round++;
+            }
+        }
+    }
+}
+
+// CRC-8 with polynomial 0x07 and init 0x00 (CRC-8/SMBUS) has the check value 0xF4
+static void checkCrc() {
+    const char *digits = "123456789";
+    check(LoRaPacket::crc8((const uint8_t *)digits, strlen(digits)) == 0xF4, "CRC-8 check value", 0);
+}
+
+static void flipBit(uint8_t *data, size_t bit) {
+    data[bit / 8] ^= (uint8_t)(0x80 >> (bit % 8));
+}
+
+// Every header damaged in one to three bits fails, the CRC byte included: the CRC-8 has a Hamming
+// distance of 4 over the 40 header bits
+static void checkCorruptedHeader() {
+    uint8_t packet[LoRaPacket::MAX_PACKET];
+    LoRaPacket::Header sent = {LoRaPacket::TYPE_TURBO, 0x2A17, 60}, received;
+    size_t size = buildPacket(sent, packet);
+    const size_t bits = LoRaPacket::HEADER_SIZE * 8;
+    int accepted = 0;
+
+    // i <= j <= k, a repeated index stands for fewer flipped bits
+    for (size_t i = 0; i < bits; i++) {
+        for (size_t j = i; j < bits; j++) {
+            for (size_t k = j; k < bits; k++) {
+                if (i == j && j != k) continue; // Same error as (i, k, k)
+                uint8_t damaged[LoRaPacket::MAX_PACKET];
+                memcpy(damaged, packet, size);
+                flipBit(damaged, i);
+                if (j != i) flipBit(damaged, j);
+                if (k != j) flipBit(damaged, k);
+                accepted += LoRaPacket::parse(damaged, size, received) ? 1 : 0;
+            }
+        }
+    }
+    check(accepted == 0, "one- to three-bit header errors rejected", accepted);
+
+    // A damaged CRC byte alone
+    packet[4] ^= 0x5A;
+    check(!LoRaPacket::parse(packet, size, received), "corrupted header CRC", 0);
+}
+
+// Headers with a valid CRC that still do not describe this packet
+static void checkRejection() {
+    uint8_t packet[LoRaPacket::MAX_PACKET + 1];
+    LoRaPacket::Header sent = {LoRaPacket::TYPE_REED_SOLOMON, 7, 20}, received;
+    size_t size = buildPacket(sent, packet);
+
+    // Another version or an unknown type, CRC recomputed
+    for (int nibble = 0; nibble < 16; nibble++) {
+        uint8_t foreign[LoRaPacket::MAX_PACKET];
+        memcpy(foreign, packet, size);
+        foreign[0] = (uint8_t)(nibble << 4 | LoRaPacket::TYPE_REED_SOLOMON);
+        foreign[4] = LoRaPacket::crc8(foreign, LoRaPacket::HEADER_SIZE - 1);
+        check(LoRaPacket::parse(foreign, size, received) == (nibble == LoRaPacket::VERSION), "version nibble", nibble);
+
+        foreign[0] = (uint8_t)(LoRaPacket::VERSION << 4 | nibble);
+        foreign[4] = LoRaPacket::crc8(foreign, LoRaPacket::HEADER_SIZE - 1);
+        bool known = nibble >= LoRaPacket::TYPE_REED_SOLOMON && nibble <= LoRaPacket::TYPE_INTERLEAVED;
+        check(LoRaPacket::parse(foreign, size, received) == known, "type nibble", nibble);
+    }
+
+    // The payload length must match the packet exactly
+    check(!LoRaPacket::parse(packet, size - 1, received), "packet shorter than its payload length", 0);
+    check(!LoRaPacket::parse(packet, size + 1, received), "packet longer than its payload length", 0);
+    check(!LoRaPacket::parse(packet, LoRaPacket::HEADER_SIZE - 1, received), "packet shorter than a header", 0);
+    check(!LoRaPacket::parse(packet, LoRaPacket::MAX_PACKET + 1, received), "packet longer than LoRa allows", 0);
+}
+
+// Random bytes of random length, as a foreign LoRa transmitter on the same channel would send:
+// header CRC, version, type and length together let almost none through
+static void checkForeignPackets() {
+    const int count = 200000;
+    int accepted = 0;
+    for (int n = 0; n < count; n++) {
+        uint8_t packet[LoRaPacket::MAX_PACKET];
+        size_t size = rng() % (LoRaPacket::MAX_PACKET + 1);
+        for (size_t i = 0; i < size; i++) packet[i] = (uint8_t)rng();
+        LoRaPacket::Header received;
+        accepted += LoRaPacket::parse(packet, size, received) ? 1 : 0;
+    }
+    printf("%d of %d random packets accepted\n", accepted, count);
+    check(accepted <= 1, "random packets rejected", accepted);
+}
+
+int main() {
+    checkRoundTrip();
+    checkCrc();
+    checkCorruptedHeader();
+    checkRejection();
+    checkForeignPackets();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All LoRaPacket checks passed\n");
+    return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef PRESSURE_BATCH_H
+#define PRESSURE_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Barometer samples taken between two telemetry frames, sent after the key or delta frame:
+//   offset size field
+//    0     1   sample count
+//    1     1   sample period, ms
+//    2     2   age of the first sample when the frame was built, ms, little-endian
+//    4     ... one varint per sample: the zig-zag pressure step in Pa shifted left by one, with bit 0 set
+//              when sample slots were missed before it; then a varint with the missed slots minus one
+// The first step is taken from the pressure field of the frame, the others from the previous sample,
+// so a steady descent costs one byte per sample
+class PressureBatch {
+public:
+    static constexpr size_t HEADER_SIZE = 4;   // Count, period and age
+    static constexpr size_t MAX_SAMPLES = 255; // Largest sample count
+
+    struct Sample {
+        uint32_t pressure; // Pa
+        uint32_t slot;     // Sample slot, period ms apart
+    };
+
+    // Encodes samples oldest first, as many as fit outSize. Returns the bytes written, 0 if not even
+    // one sample fits; used is set to the number of samples encoded
+    static size_t encode(const Sample *samples, size_t count, uint8_t periodMs, uint16_t ageMs,
+                         uint32_t referencePa, uint8_t *out, size_t outSize, size_t &used);
+
+    // Decodes a batch that fills data exactly, the slots counting from 0 at the first sample.
+    // samples may be nullptr to only check the batch.
+    // Returns the sample count, 0 if data is not a valid batch or holds more than maxSamples
+    static size_t decode(const uint8_t *data, size_t length, uint32_t referencePa, Sample *samples,
+                         size_t maxSamples, uint8_t &periodMs, uint16_t &ageMs);
+};
+
+#endif // PRESSURE_BATCH_H
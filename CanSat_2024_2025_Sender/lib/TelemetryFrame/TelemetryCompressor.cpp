@@ -0,0 +1,135 @@
+#include "TelemetryCompressor.h"
+#include "Varint.h"
+#include <string.h>
+
+static constexpr size_t DELTA_HEADER = 2; // Version and key reference
+
+static constexpr bool wordsFit32() {
+    for (size_t i = 0; i < TelemetryFrame::WORD_COUNT; i++) {
+        if (TelemetryFrame::WORD_OFFSETS[i + 1] - TelemetryFrame::WORD_OFFSETS[i] > 4) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(wordsFit32(), "Words are diffed as 32-bit integers");
+
+// Word i of a frame, little-endian
+static uint32_t word(const uint8_t *frame, size_t i, size_t &width) {
+    size_t offset = TelemetryFrame::WORD_OFFSETS[i];
+    width = TelemetryFrame::WORD_OFFSETS[i + 1] - offset;
+    uint32_t value = 0;
+    for (size_t b = 0; b < width; b++) {
+        value |= (uint32_t)frame[offset + b] << (8 * b);
+    }
+    return value;
+}
+
+// Difference of two words wrapped to the word width, as a signed value
+static int32_t wrappedDelta(uint32_t value, uint32_t base, size_t width) {
+    unsigned shift = 32 - 8 * width;
+    return (int32_t)((value - base) << shift) >> shift;
+}
+
+TelemetryCompressor::TelemetryCompressor(uint8_t keyInterval)
+    : keyInterval(keyInterval > 0 ? keyInterval : 1), sinceKey(this->keyInterval) {
+    memset(key, 0, sizeof(key));
+}
+
+void TelemetryCompressor::forceKeyFrame() {
+    sinceKey = keyInterval;
+}
+
+size_t TelemetryCompressor::compress(const uint8_t *frame, uint8_t *out) {
+    if (sinceKey < keyInterval) {
+        // Worst case a varint per word is 5 bytes, so encode into scratch space first
+        uint8_t delta[DELTA_HEADER + 5 * TelemetryFrame::WORD_COUNT];
+        size_t length = DELTA_HEADER;
+        delta[0] = DELTA_VERSION;
+        delta[1] = key[TelemetryFrame::WORD_OFFSETS[0]]; // Low byte of the key message number
+        for (size_t i = 0; i < TelemetryFrame::WORD_COUNT; i++) {
+            size_t width;
+            uint32_t base = word(key, i, width);
+            length += putVarint(delta + length, zigzagEncode(wrappedDelta(word(frame, i, width), base, width)));
+        }
+
+        // The receiver tells key from delta frames by their version byte, and a delta frame as long
+        // as a key frame would not save anything
+        if (length < TelemetryFrame::SIZE) {
+            memcpy(out, delta, length);
+            sinceKey++;
+            return length;
+        }
+    }
+
+    memcpy(key, frame, TelemetryFrame::SIZE);
+    memcpy(out, frame, TelemetryFrame::SIZE);
+    sinceKey = 1;
+    return TelemetryFrame::SIZE;
+}
+
+TelemetryDecompressor::TelemetryDecompressor() : hasKey(false) {
+    memset(key, 0, sizeof(key));
+}
+
+bool TelemetryDecompressor::recognized(const uint8_t *data, size_t length) {
+    if (length == TelemetryFrame::SIZE) {
+        return data[0] == TelemetryFrame::VERSION;
+    }
+    return length >= DELTA_HEADER + TelemetryFrame::WORD_COUNT && length < TelemetryFrame::SIZE &&
+           data[0] == TelemetryCompressor::DELTA_VERSION;
+}
+
+size_t TelemetryDecompressor::frameLength(const uint8_t *data, size_t length) {
+    if (length >= TelemetryFrame::SIZE && data[0] == TelemetryFrame::VERSION) {
+        return TelemetryFrame::SIZE;
+    }
+    if (length < DELTA_HEADER || data[0] != TelemetryCompressor::DELTA_VERSION) {
+        return 0;
+    }
+
+    // A delta frame ends after its last varint
+    size_t pos = DELTA_HEADER;
+    for (size_t i = 0; i < TelemetryFrame::WORD_COUNT; i++) {
+        uint32_t delta;
+        if (!getVarint(data, length, pos, delta)) {
+            return 0;
+        }
+    }
+    return pos < TelemetryFrame::SIZE ? pos : 0;
+}
+
+bool TelemetryDecompressor::decompress(const uint8_t *data, size_t length, uint8_t *frame) {
+    if (!recognized(data, length)) {
+        return false;
+    }
+    if (length == TelemetryFrame::SIZE) {
+        memcpy(key, data, TelemetryFrame::SIZE);
+        memcpy(frame, data, TelemetryFrame::SIZE);
+        hasKey = true;
+        return true;
+    }
+    if (!hasKey || data[1] != key[TelemetryFrame::WORD_OFFSETS[0]]) {
+        return false; // The key frame of this delta was lost
+    }
+
+    uint8_t restored[TelemetryFrame::SIZE];
+    restored[0] = TelemetryFrame::VERSION;
+    size_t pos = DELTA_HEADER;
+    for (size_t i = 0; i < TelemetryFrame::WORD_COUNT; i++) {
+        uint32_t delta;
+        if (!getVarint(data, length, pos, delta)) {
+            return false;
+        }
+        size_t width;
+        uint32_t value = word(key, i, width) + (uint32_t)zigzagDecode(delta);
+        for (size_t b = 0; b < width; b++) {
+            restored[TelemetryFrame::WORD_OFFSETS[i] + b] = (uint8_t)(value >> (8 * b));
+        }
+    }
+    if (pos != length) {
+        return false;
+    }
+    memcpy(frame, restored, TelemetryFrame::SIZE);
+    return true;
+}
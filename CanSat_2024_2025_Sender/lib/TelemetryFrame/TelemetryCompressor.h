@@ -0,0 +1,57 @@
+#ifndef TELEMETRY_COMPRESSOR_H
+#define TELEMETRY_COMPRESSOR_H
+
+#include "TelemetryFrame.h"
+
+// Delta compression of successive telemetry frames.
+// Every keyInterval-th frame is sent whole as a key frame. The frames in between are delta frames:
+//   offset size field
+//    0     1   DELTA_VERSION
+//    1     1   low byte of the message number of the key frame they refer to
+//    2     ... one zig-zag varint per TelemetryFrame word, the word minus the same word of the key frame
+// Deltas are taken against the key frame, not the previous frame, so a lost delta frame costs
+// nothing and a lost key frame only the deltas up to the next one
+class TelemetryCompressor {
+public:
+    static constexpr uint8_t DELTA_VERSION = 0x80 | TelemetryFrame::VERSION; // Version byte of delta frames
+    static constexpr uint8_t DEFAULT_KEY_INTERVAL = 8; // Frames per key frame when none is given
+
+    TelemetryCompressor(uint8_t keyInterval = DEFAULT_KEY_INTERVAL);
+
+    // Compresses one TelemetryFrame::SIZE byte frame into out, which holds at least TelemetryFrame::SIZE bytes.
+    // A delta that would not be shorter than the frame is sent as a key frame. Returns the length written
+    size_t compress(const uint8_t *frame, uint8_t *out);
+
+    void forceKeyFrame(); // Sends the next frame as a key frame
+
+private:
+    uint8_t keyInterval;                   // Frames per key frame
+    uint8_t sinceKey;                      // Frames since the last key frame, keyInterval forces one
+    uint8_t key[TelemetryFrame::SIZE];     // Last key frame
+};
+
+// Restores the frames of a TelemetryCompressor. Only feed it frames that passed their error
+// correction or CRC: a damaged key frame would spoil the deltas up to the next one
+class TelemetryDecompressor {
+public:
+    TelemetryDecompressor();
+
+    // Restores the full TelemetryFrame::SIZE byte frame of a key or delta frame. False if the data is
+    // neither, or a delta frame whose key frame did not arrive; the next key frame resynchronizes
+    bool decompress(const uint8_t *data, size_t length, uint8_t *frame);
+
+    // Checks the shape of a key or delta frame without decoding it
+    static bool recognized(const uint8_t *data, size_t length);
+
+    // Length of the key or delta frame at the start of data, 0 if there is none. A message can carry
+    // more after its frame, such as a PressureBatch
+    static size_t frameLength(const uint8_t *data, size_t length);
+
+    bool synchronized() const { return hasKey; } // Checks if a key frame has arrived
+
+private:
+    bool hasKey;                           // key holds a received key frame
+    uint8_t key[TelemetryFrame::SIZE];     // Last key frame
+};
+
+#endif // TELEMETRY_COMPRESSOR_H
@@ -0,0 +1,299 @@
+#include "TelemetryFrame.h"
+#include <math.h>
+
+static_assert(TelemetryFrame::SIZE == 30, "The field table no longer gives the version 1 layout");
+
+// Powers of ten of the fixed-point decimals
+static const uint32_t POW10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+// Appends text to a fixed buffer without heap use or printf, dropping what does not fit
+struct TextWriter {
+    char *text;
+    size_t size;
+    size_t length;
+
+    void put(char c) {
+        if (length + 1 < size) {
+            text[length++] = c;
+        }
+    }
+
+    void putString(const char *s) {
+        while (*s) {
+            put(*s++);
+        }
+    }
+
+    // Decimal digits of an unsigned value, at least minDigits with leading zeros
+    void putUnsigned(uint32_t value, size_t minDigits = 1) {
+        char digits[10];
+        size_t n = 0;
+        do {
+            digits[n++] = (char)('0' + value % 10);
+            value /= 10;
+        } while (value > 0 || n < minDigits);
+        while (n > 0) {
+            put(digits[--n]);
+        }
+    }
+
+    void putSigned(int32_t value) {
+        if (value < 0) {
+            put('-');
+            putUnsigned(0u - (uint32_t)value);
+        } else {
+            putUnsigned((uint32_t)value);
+        }
+    }
+
+    // Value rounded to a fixed number of decimals (at most 9), in 32-bit integer arithmetic after
+    // one scaling; NaN, infinity and integer parts beyond 32 bits print as "nan", "inf" and "ovf".
+    // Rounds the exact binary value half to even, so the digits match printf
+    void putFixed(double value, unsigned decimals) {
+        if (isnan(value)) {
+            putString("nan");
+            return;
+        }
+        if (signbit(value)) {
+            put('-');
+            value = -value;
+        }
+        if (isinf(value)) {
+            putString("inf");
+            return;
+        }
+        if (value >= 4294967295.0) {
+            putString("ovf");
+            return;
+        }
+        uint32_t whole = (uint32_t)value;
+        double rest = value - whole;
+        double scaled = rest * POW10[decimals];
+        double error = fma(rest, POW10[decimals], -scaled); // The exact product is scaled + error
+        uint32_t fraction = (uint32_t)scaled;
+        double aboveHalf = (scaled - fraction - 0.5) + error;
+        if (aboveHalf > 0 || (aboveHalf == 0 && (fraction & 1))) {
+            fraction++;
+        }
+        if (fraction >= POW10[decimals]) { // Rounded up into the integer part
+            fraction -= POW10[decimals];
+            whole++;
+        }
+        putUnsigned(whole);
+        if (decimals > 0) {
+            put('.');
+            putUnsigned(fraction, decimals);
+        }
+    }
+};
+
+// Offset of the highest byte that is not sign fill, the byte a bit error most likely hit
+static size_t topByte(const uint8_t *p, size_t bytes, bool isSigned) {
+    uint8_t fill = isSigned && (p[bytes - 1] & 0x80) ? 0xFF : 0x00;
+    size_t i = bytes - 1;
+    while (i > 0 && p[i] == fill) {
+        i--;
+    }
+    return i;
+}
+
+// Compile-time properties of field I of the table
+template <size_t I>
+struct FieldCodec {
+    static constexpr const TelemetrySchema::FieldType<I> &spec = std::get<I>(TelemetrySchema::FIELDS);
+    using Type = typename TelemetrySchema::FieldType<I>::Type;
+
+    static constexpr size_t OFFSET = TelemetrySchema::bitOffset(I); // Bit position in the frame
+    static constexpr size_t BITS = spec.bits;
+    static constexpr size_t FIRST = OFFSET / 8;                       // First byte of the field
+    static constexpr size_t SHIFT = OFFSET % 8;                       // Position in the first byte
+    static constexpr size_t BYTES = (SHIFT + BITS + 7) / 8;           // Bytes the field touches
+    static constexpr bool REAL = std::is_floating_point<Type>::value; // NaN is sent as INVALID
+    static constexpr int64_t MIN_RAW = spec.isSigned ? -((int64_t)1 << (BITS - 1)) : 0;
+    static constexpr int64_t MAX_RAW = spec.isSigned ? ((int64_t)1 << (BITS - 1)) - 1 : ((int64_t)1 << BITS) - 1;
+    static constexpr int64_t INVALID = spec.isSigned ? MIN_RAW : MAX_RAW;
+
+    // Shift register wide enough for the field and its position in the first byte
+    using Word = typename std::conditional<SHIFT + BITS <= 32, uint32_t, uint64_t>::type;
+    static constexpr Word MASK = (Word)((((uint64_t)1 << BITS) - 1) << SHIFT);
+
+    static_assert(BITS > 0 && BITS <= 32, "Fields are 1 to 32 bits wide");
+    static_assert(REAL || spec.scale == 1, "Integer members are sent unscaled");
+    static_assert(!REAL || spec.bias == 0, "Only integer members take a bias");
+    static_assert(spec.low >= MIN_RAW && spec.high <= MAX_RAW, "Plausible range outside the field");
+
+    // Frame value of the member, clamped to the field; NaN becomes INVALID, which no reading takes
+    static int64_t raw(const Telemetry &sample) {
+        Type value = sample.*spec.member;
+        if constexpr (REAL) {
+            constexpr int64_t low = INVALID == MIN_RAW ? MIN_RAW + 1 : MIN_RAW;
+            constexpr int64_t high = INVALID == MAX_RAW ? MAX_RAW - 1 : MAX_RAW;
+            if (isnan(value)) {
+                return INVALID;
+            }
+            double v = round(value * spec.scale);
+            return v <= (double)low ? low : v >= (double)high ? high : (int64_t)v;
+        } else {
+            int64_t v = (int64_t)value - spec.bias;
+            return v < MIN_RAW ? MIN_RAW : v > MAX_RAW ? MAX_RAW : v;
+        }
+    }
+
+    static void pack(const Telemetry &sample, uint8_t *frame) {
+        Word bits = (Word)((Word)raw(sample) << SHIFT) & MASK;
+        for (size_t i = 0; i < BYTES; i++) {
+            uint8_t keep = (uint8_t)~(MASK >> (8 * i));
+            frame[FIRST + i] = (uint8_t)((frame[FIRST + i] & keep) | (uint8_t)(bits >> (8 * i)));
+        }
+    }
+
+    // Frame value of the field, sign-extended
+    static int64_t read(const uint8_t *frame) {
+        Word word = 0;
+        for (size_t i = 0; i < BYTES; i++) {
+            word |= (Word)frame[FIRST + i] << (8 * i);
+        }
+        int64_t value = (int64_t)((word & MASK) >> SHIFT);
+        if constexpr (spec.isSigned) {
+            constexpr int64_t sign = (int64_t)1 << (BITS - 1);
+            value = (value ^ sign) - sign;
+        }
+        return value;
+    }
+
+    static void unpack(const uint8_t *frame, Telemetry &sample) {
+        int64_t value = read(frame);
+        if constexpr (REAL) {
+            sample.*spec.member = value == INVALID ? NAN : value / (double)spec.scale;
+        } else {
+            sample.*spec.member = (Type)(value + spec.bias);
+        }
+    }
+
+    static void print(const Telemetry &sample, TextWriter &out) {
+        if constexpr (spec.column > 0) {
+            out.put(spec.separator);
+        }
+        Type value = sample.*spec.member;
+        if constexpr (REAL) {
+            out.putFixed(value, spec.decimals);
+        } else if constexpr (std::is_signed<Type>::value) {
+            out.putSigned((int32_t)value);
+        } else {
+            out.putUnsigned((uint32_t)value);
+        }
+    }
+
+    static void printName(TextWriter &out) {
+        if constexpr (spec.column > 0) {
+            out.put(spec.separator);
+        }
+        out.putString(spec.name);
+    }
+
+    // Frame byte a bit error most likely hit if the field is out of its plausible range, -1 if it is not.
+    // Whole-byte fields point at their highest significant byte, narrower ones at the byte of their top bit
+    static int implausibleByte(const uint8_t *frame) {
+        if constexpr (spec.low == MIN_RAW && spec.high == MAX_RAW) {
+            return -1;
+        } else {
+            int64_t value = read(frame);
+            if ((REAL && value == INVALID) || (value >= spec.low && value <= spec.high)) {
+                return -1;
+            }
+            if constexpr (SHIFT == 0 && BITS % 8 == 0) {
+                return (int)(FIRST + topByte(frame + FIRST, BITS / 8, spec.isSigned));
+            } else {
+                return (int)((OFFSET + BITS - 1) / 8);
+            }
+        }
+    }
+};
+
+// Every field once, in frame order
+template <size_t... I>
+static void packAll(const Telemetry &sample, uint8_t *frame, std::index_sequence<I...>) {
+    (FieldCodec<I>::pack(sample, frame), ...);
+}
+
+template <size_t... I>
+static void unpackAll(const uint8_t *frame, Telemetry &sample, std::index_sequence<I...>) {
+    (FieldCodec<I>::unpack(frame, sample), ...);
+}
+
+// Every field once, in CSV column order
+template <size_t... C>
+static void printAll(const Telemetry &sample, TextWriter &out, std::index_sequence<C...>) {
+    (FieldCodec<TelemetrySchema::fieldOfColumn(C)>::print(sample, out), ...);
+}
+
+template <size_t... C>
+static void printNames(TextWriter &out, std::index_sequence<C...>) {
+    (FieldCodec<TelemetrySchema::fieldOfColumn(C)>::printName(out), ...);
+}
+
+template <size_t... I>
+static size_t implausibleAll(const uint8_t *frame, uint8_t *positions, size_t count, size_t maxPositions,
+                             std::index_sequence<I...>) {
+    int found[] = {FieldCodec<I>::implausibleByte(frame)...};
+    for (int pos : found) {
+        if (pos >= 0 && count < maxPositions && (count == 0 || positions[count - 1] != pos)) {
+            positions[count++] = (uint8_t)pos;
+        }
+    }
+    return count;
+}
+
+using FieldIndices = std::make_index_sequence<TelemetrySchema::FIELD_COUNT>;
+
+size_t TelemetryFrame::serialize(const Telemetry &sample, uint8_t *out, size_t outSize) {
+    if (outSize < SIZE) {
+        return 0;
+    }
+    out[0] = VERSION;
+    packAll(sample, out, FieldIndices());
+    return SIZE;
+}
+
+bool TelemetryFrame::parse(const uint8_t *frame, size_t length, Telemetry &sample) {
+    if (length != SIZE || frame[0] != VERSION) {
+        return false;
+    }
+    unpackAll(frame, sample, FieldIndices());
+    return true;
+}
+
+size_t TelemetryFrame::format(const Telemetry &sample, char *text, size_t textSize) {
+    if (textSize == 0) {
+        return 0;
+    }
+    TextWriter out = {text, textSize, 0};
+    printAll(sample, out, FieldIndices());
+    text[out.length] = '\0';
+    return out.length;
+}
+
+size_t TelemetryFrame::header(char *text, size_t textSize) {
+    if (textSize == 0) {
+        return 0;
+    }
+    TextWriter out = {text, textSize, 0};
+    printNames(out, FieldIndices());
+    text[out.length] = '\0';
+    return out.length;
+}
+
+uint32_t TelemetryFrame::pressureField(const uint8_t *frame) {
+    return (uint32_t)FieldCodec<TelemetrySchema::index(&Telemetry::pressure)>::read(frame);
+}
+
+size_t TelemetryFrame::implausibleBytes(const uint8_t *frame, size_t length, uint8_t *positions, size_t maxPositions) {
+    if (length < SIZE || maxPositions == 0) {
+        return 0;
+    }
+    size_t count = 0;
+    if (frame[0] != VERSION) {
+        positions[count++] = 0;
+    }
+    return implausibleAll(frame, positions, count, maxPositions, FieldIndices());
+}
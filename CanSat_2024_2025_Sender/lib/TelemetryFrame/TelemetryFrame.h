@@ -0,0 +1,55 @@
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include "TelemetrySchema.h"
+
+// Versioned binary telemetry frame, the payload of the Reed-Solomon and Turbo packets.
+// The layout is generated from TelemetrySchema::FIELDS; all fields are little-endian scaled integers:
+//   offset size field
+//    0     1   version (VERSION)
+//    1     2   message number
+//    3     4   latitude, 1e-7 degrees
+//    7     4   longitude, 1e-7 degrees
+//   11     4   date and time: second 0-5, minute 6-11, hour 12-16, day 17-21, month 22-25, year-2000 26-31
+//   15     2   speed, 0.01 km/h
+//   17     2   course, 0.01 degrees
+//   19     4   altitude, cm
+//   23     1   satellites
+//   24     4   pressure, Pa
+//   28     2   temperature, 0.01 Celsius
+// A NaN reading is sent as the lowest value of a signed field and the highest of an unsigned one.
+// A new layout gets a new version, so the receiver never misreads an older or newer sender
+class TelemetryFrame {
+public:
+    static constexpr uint8_t VERSION = 1;  // Layout of this header
+    static constexpr size_t SIZE = TelemetrySchema::FRAME_BITS / 8; // Frame length in bytes
+    static constexpr size_t TEXT_SIZE = 128; // Buffer that holds every CSV line of format()
+    static constexpr size_t WORD_COUNT = TelemetrySchema::WORD_COUNT; // Byte-aligned words after the version byte
+
+    // Offsets of the words after the version byte, the last entry is SIZE; word i is
+    // WORD_OFFSETS[i + 1] - WORD_OFFSETS[i] bytes long
+    static constexpr std::array<uint8_t, WORD_COUNT + 1> WORD_OFFSETS = TelemetrySchema::wordOffsets();
+
+    // Packs a sample into SIZE bytes, out of range values are clamped. Returns SIZE, 0 if outSize is too small
+    static size_t serialize(const Telemetry &sample, uint8_t *out, size_t outSize);
+
+    // Unpacks a frame, false if the length or version does not match this layout
+    static bool parse(const uint8_t *frame, size_t length, Telemetry &sample);
+
+    // Writes the sample as the comma-separated line the sender logs, returns its length.
+    // Integer and fixed-point formatting into text only: no heap, no printf, no String
+    static size_t format(const Telemetry &sample, char *text, size_t textSize);
+
+    // Writes the CSV header naming the fields of format() with the same separators, returns its length
+    static size_t header(char *text, size_t textSize);
+
+    // Raw pressure field of a frame in Pa, the reference of its PressureBatch; UINT32_MAX for a NaN reading
+    static uint32_t pressureField(const uint8_t *frame);
+
+    // Flags the highest significant byte of every field that is out of its physical range, and the
+    // version byte if it is wrong; these bytes are the likely symbol errors of a damaged frame.
+    // Returns the number of flagged bytes, at most maxPositions
+    static size_t implausibleBytes(const uint8_t *frame, size_t length, uint8_t *positions, size_t maxPositions);
+};
+
+#endif // TELEMETRY_FRAME_H
@@ -0,0 +1,155 @@
+#ifndef TELEMETRY_SCHEMA_H
+#define TELEMETRY_SCHEMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// One telemetry sample in the units the sensors report
+struct Telemetry {
+    uint16_t messageNumber;       // Message counter, wraps at 65536
+    double latitude;              // Degrees
+    double longitude;             // Degrees
+    int day, month, year;         // GPS date
+    int hour, minute, second;     // GPS time
+    double speedKPH;              // km/h
+    double course;                // Degrees
+    double altitude;              // Meters
+    uint32_t satellites;          // Satellites in view
+    double pressure;              // hPa
+    double temperature;           // Celsius
+};
+
+// The one description of the telemetry fields: their order and width in the binary frame, their
+// scaling and their place in the CSV line. TelemetryFrame generates serialize, parse, format and
+// the plausibility checks from it at compile time, for the sender, the receiver and the host tools
+namespace TelemetrySchema {
+
+// One field of the frame, carrying one member of Telemetry
+template <typename T>
+struct Field {
+    using Type = T;
+
+    const char *name;       // CSV header name
+    T Telemetry::*member;   // Sample member the field carries
+    uint8_t bits;           // Width in the frame, at most 32
+    bool isSigned;          // Two's complement field
+    int32_t scale;          // Frame units per sample unit, 1 for integer members
+    int32_t bias;           // Subtracted from integer members before packing
+    int64_t low, high;      // Plausible range in frame units, checked by implausibleBytes
+    uint8_t decimals;       // Decimals of floating-point members in the CSV line
+    uint8_t column;         // Position in the CSV line
+    char separator;         // Printed before the field in the CSV line, unused for column 0
+};
+
+// The fields follow the version byte bit by bit, least significant bit first, so byte-wide fields
+// are plain little-endian integers and narrow ones share bytes. Floating-point members are sent
+// rounded to scale, with NaN as the lowest value of a signed field and the highest of an unsigned one.
+// The plausible ranges are the physical ones: 100 km of altitude is far above any CanSat flight, 64
+// satellites more than any receiver tracks, pressure and temperature stay in the BMP280 range.
+// Every change here that moves a bit needs a new TelemetryFrame::VERSION
+inline constexpr auto FIELDS = std::make_tuple(
+    //              name             member                     bits signed scale     bias  low          high        dec col sep
+    Field<uint16_t>{"message",       &Telemetry::messageNumber, 16,  false, 1,        0,    0,           UINT16_MAX, 0,  0,  ','},
+    Field<double>  {"latitude",      &Telemetry::latitude,      32,  true,  10000000, 0,    -900000000,  900000000,  6,  1,  ','},
+    Field<double>  {"longitude",     &Telemetry::longitude,     32,  true,  10000000, 0,    -1800000000, 1800000000, 6,  2,  ','},
+    Field<int>     {"second",        &Telemetry::second,        6,   false, 1,        0,    0,           59,         0,  8,  ':'},
+    Field<int>     {"minute",        &Telemetry::minute,        6,   false, 1,        0,    0,           59,         0,  7,  ':'},
+    Field<int>     {"hour",          &Telemetry::hour,          5,   false, 1,        0,    0,           23,         0,  6,  ','},
+    Field<int>     {"day",           &Telemetry::day,           5,   false, 1,        0,    0,           31,         0,  3,  ','},
+    Field<int>     {"month",         &Telemetry::month,         4,   false, 1,        0,    0,           12,         0,  4,  '/'},
+    Field<int>     {"year",          &Telemetry::year,          6,   false, 1,        2000, 0,           63,         0,  5,  '/'},
+    Field<double>  {"speed_kph",     &Telemetry::speedKPH,      16,  false, 100,      0,    0,           UINT16_MAX, 2,  9,  ','},
+    Field<double>  {"course",        &Telemetry::course,        16,  false, 100,      0,    0,           36000,      2,  10, ','},
+    Field<double>  {"altitude_m",    &Telemetry::altitude,      32,  true,  100,      0,    -10000000,   10000000,   2,  11, ','},
+    Field<uint32_t>{"satellites",    &Telemetry::satellites,    8,   false, 1,        0,    0,           64,         0,  12, ','},
+    Field<double>  {"pressure_hpa",  &Telemetry::pressure,      32,  false, 100,      0,    0,           120000,     2,  13, ','},
+    Field<double>  {"temperature_c", &Telemetry::temperature,   16,  true,  100,      0,    -4000,       8500,       2,  14, ','});
+
+inline constexpr size_t FIELD_COUNT = std::tuple_size<std::decay_t<decltype(FIELDS)>>::value;
+inline constexpr size_t HEADER_BITS = 8; // Version byte in front of the fields
+
+template <size_t I>
+using FieldType = std::decay_t<std::tuple_element_t<I, std::decay_t<decltype(FIELDS)>>>;
+
+template <size_t... I>
+constexpr std::array<uint8_t, sizeof...(I)> collectBits(std::index_sequence<I...>) {
+    return {{std::get<I>(FIELDS).bits...}};
+}
+
+template <size_t... I>
+constexpr std::array<uint8_t, sizeof...(I)> collectColumns(std::index_sequence<I...>) {
+    return {{std::get<I>(FIELDS).column...}};
+}
+
+inline constexpr auto BITS = collectBits(std::make_index_sequence<FIELD_COUNT>());
+inline constexpr auto COLUMNS = collectColumns(std::make_index_sequence<FIELD_COUNT>());
+
+// Bit position of field i in the frame, counting the version byte
+constexpr size_t bitOffset(size_t i) {
+    size_t offset = HEADER_BITS;
+    for (size_t f = 0; f < i; f++) {
+        offset += BITS[f];
+    }
+    return offset;
+}
+
+inline constexpr size_t FRAME_BITS = bitOffset(FIELD_COUNT);
+static_assert(FRAME_BITS % 8 == 0, "The fields do not fill whole bytes");
+
+// Field printed in CSV column c, FIELD_COUNT if none
+constexpr size_t fieldOfColumn(size_t c) {
+    for (size_t f = 0; f < FIELD_COUNT; f++) {
+        if (COLUMNS[f] == c) {
+            return f;
+        }
+    }
+    return FIELD_COUNT;
+}
+
+// Index of the field carrying member, FIELD_COUNT if none
+template <typename T, size_t I = 0>
+constexpr size_t index(T Telemetry::*member) {
+    if constexpr (I == FIELD_COUNT) {
+        return FIELD_COUNT;
+    } else {
+        if constexpr (std::is_same<typename FieldType<I>::Type, T>::value) {
+            if (std::get<I>(FIELDS).member == member) {
+                return I;
+            }
+        }
+        return index<T, I + 1>(member);
+    }
+}
+
+// Words are the byte-aligned runs of the frame after the version byte: every field that starts on a
+// byte boundary opens one, narrower fields join it. Delta compression works word by word
+constexpr size_t wordCount() {
+    size_t count = 0;
+    for (size_t f = 0; f < FIELD_COUNT; f++) {
+        count += bitOffset(f) % 8 == 0;
+    }
+    return count;
+}
+
+inline constexpr size_t WORD_COUNT = wordCount();
+
+// Byte offsets of the words, the last entry is the frame size
+constexpr std::array<uint8_t, WORD_COUNT + 1> wordOffsets() {
+    std::array<uint8_t, WORD_COUNT + 1> offsets{};
+    size_t w = 0;
+    for (size_t f = 0; f < FIELD_COUNT; f++) {
+        if (bitOffset(f) % 8 == 0) {
+            offsets[w++] = (uint8_t)(bitOffset(f) / 8);
+        }
+    }
+    offsets[w] = (uint8_t)(FRAME_BITS / 8);
+    return offsets;
+}
+
+} // namespace TelemetrySchema
+
+#endif // TELEMETRY_SCHEMA_H
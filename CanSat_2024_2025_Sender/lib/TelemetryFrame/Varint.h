@@ -0,0 +1,40 @@
+#ifndef TELEMETRY_VARINT_H
+#define TELEMETRY_VARINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Zig-zag mapping: small values of either sign become small unsigned values
+inline uint32_t zigzagEncode(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+inline int32_t zigzagDecode(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// LEB128 varint, 7 bits per byte, at most 5 bytes. Returns the bytes written
+inline size_t putVarint(uint8_t *out, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+// Reads a varint at pos and moves pos past it, false if it runs past length or over 5 bytes
+inline bool getVarint(const uint8_t *data, size_t length, size_t &pos, uint32_t &value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 35 && pos < length; shift += 7) {
+        uint8_t byte = data[pos++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // TELEMETRY_VARINT_H
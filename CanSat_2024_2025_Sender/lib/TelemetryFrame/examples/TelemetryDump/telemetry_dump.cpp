@@ -0,0 +1,94 @@
+/* Host parser for logged telemetry frames, not an Arduino sketch.
+ * It sits under examples/ so the firmware build leaves it out.
+ *
+ * Build and run from this directory:
+ *   g++ -O2 -I../.. telemetry_dump.cpp ../../TelemetryFrame.cpp ../../TelemetryCompressor.cpp \
+ *       ../../PressureBatch.cpp -o telemetry_dump
+ *   ./telemetry_dump [--header] < frames.txt
+ * Every input line holds one message as hex digits, spaces allowed, in the order they were
+ * received: a key or delta frame, optionally followed by a pressure batch. Every frame is printed
+ * as the CSV line the sender logged for it, a batch as a "PRESSURE:" line below it with one
+ * "ms/Pa" pair per sample, ms counting back from the frame; frames of another version, deltas
+ * whose key frame is missing and damaged batches are reported on stderr. --header starts the
+ * output with the CSV header line, the field names of TelemetrySchema. */
+
+#include "TelemetryCompressor.h"
+#include "PressureBatch.h"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c = (char)tolower((unsigned char)c);
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--header") == 0) {
+        char header[TelemetryFrame::TEXT_SIZE];
+        TelemetryFrame::header(header, sizeof(header));
+        puts(header);
+    }
+
+    char line[1024];
+    size_t lineNumber = 0;
+    TelemetryDecompressor decompressor;
+    while (fgets(line, sizeof(line), stdin)) {
+        lineNumber++;
+        uint8_t frame[sizeof(line) / 2];
+        size_t length = 0;
+        int high = -1;
+        bool valid = true;
+        for (const char *p = line; *p && valid; p++) {
+            if (isspace((unsigned char)*p)) continue;
+            int v = hexValue(*p);
+            if (v < 0) {
+                valid = false;
+            } else if (high < 0) {
+                high = v;
+            } else {
+                frame[length++] = (uint8_t)(high << 4 | v);
+                high = -1;
+            }
+        }
+        if (length == 0 && valid && high < 0) continue; // Blank line
+
+        Telemetry sample;
+        uint8_t restored[TelemetryFrame::SIZE];
+        size_t frameLength = valid && high < 0 ? TelemetryDecompressor::frameLength(frame, length) : 0;
+        if (frameLength == 0) {
+            fprintf(stderr, "line %zu: not a version %u key or delta frame\n", lineNumber,
+                    (unsigned)TelemetryFrame::VERSION);
+            continue;
+        }
+        if (!decompressor.decompress(frame, frameLength, restored) ||
+            !TelemetryFrame::parse(restored, sizeof(restored), sample)) {
+            fprintf(stderr, "line %zu: delta frame without its key frame\n", lineNumber);
+            continue;
+        }
+        char text[TelemetryFrame::TEXT_SIZE];
+        TelemetryFrame::format(sample, text, sizeof(text));
+        puts(text);
+        if (frameLength == length) continue;
+
+        PressureBatch::Sample samples[PressureBatch::MAX_SAMPLES];
+        uint8_t periodMs;
+        uint16_t ageMs;
+        size_t count = PressureBatch::decode(frame + frameLength, length - frameLength,
+                                             TelemetryFrame::pressureField(restored), samples,
+                                             PressureBatch::MAX_SAMPLES, periodMs, ageMs);
+        if (count == 0) {
+            fprintf(stderr, "line %zu: damaged pressure batch\n", lineNumber);
+            continue;
+        }
+        printf("PRESSURE:%u", (unsigned)sample.messageNumber);
+        for (size_t i = 0; i < count; i++) {
+            long offset = (long)samples[i].slot * periodMs - ageMs;
+            printf(",%ld/%lu", offset, (unsigned long)samples[i].pressure);
+        }
+        putchar('\n');
+    }
+    return 0;
+}
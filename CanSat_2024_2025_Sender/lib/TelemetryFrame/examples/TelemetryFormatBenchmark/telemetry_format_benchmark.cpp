@@ -0,0 +1,126 @@
+/* Host benchmark for TelemetryFrame::format, not an Arduino sketch.
+ * It sits under examples/ so the firmware build leaves it out.
+ *
+ * Build and run from this directory:
+ *   g++ -O2 -I../.. telemetry_format_benchmark.cpp ../../TelemetryFrame.cpp -o telemetry_format_benchmark
+ *   ./telemetry_format_benchmark
+ * "String concat" stands in for the former Utils::createDataString: every field is converted into
+ * its own heap string and joined with +, like the Arduino String temporaries. "snprintf" is one
+ * printf call into a fixed buffer. Every line of format() is checked against snprintf first. */
+
+#include "TelemetryFrame.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double elapsed_ns(bench_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+}
+
+static double uniform(double low, double high) {
+    return low + (high - low) * rand() / RAND_MAX;
+}
+
+// Arduino String(double, decimals) stand-in, one heap string per conversion
+static std::string fieldString(double value, int decimals) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+    return std::string(buffer);
+}
+
+static std::string fieldString(long value) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%ld", value);
+    return std::string(buffer);
+}
+
+static std::string concatLine(const Telemetry &s) {
+    return fieldString((long)s.messageNumber) + "," +
+           fieldString(s.latitude, 6) + "," +
+           fieldString(s.longitude, 6) + "," +
+           fieldString((long)s.day) + "/" + fieldString((long)s.month) + "/" + fieldString((long)s.year) + "," +
+           fieldString((long)s.hour) + ":" + fieldString((long)s.minute) + ":" + fieldString((long)s.second) + "," +
+           fieldString(s.speedKPH, 2) + "," +
+           fieldString(s.course, 2) + "," +
+           fieldString(s.altitude, 2) + "," +
+           fieldString((long)s.satellites) + "," +
+           fieldString(s.pressure, 2) + "," +
+           fieldString(s.temperature, 2);
+}
+
+static size_t printfLine(const Telemetry &s, char *text, size_t size) {
+    return (size_t)snprintf(text, size, "%u,%.6f,%.6f,%d/%d/%d,%d:%d:%d,%.2f,%.2f,%.2f,%lu,%.2f,%.2f",
+                            (unsigned)s.messageNumber, s.latitude, s.longitude, s.day, s.month, s.year,
+                            s.hour, s.minute, s.second, s.speedKPH, s.course, s.altitude,
+                            (unsigned long)s.satellites, s.pressure, s.temperature);
+}
+
+int main() {
+    srand(1);
+    const size_t n = 4096;
+    const int rounds = 50;
+
+    // Samples as the receiver sees them: quantized by a trip through the binary frame
+    std::vector<Telemetry> samples(n);
+    for (size_t i = 0; i < n; i++) {
+        Telemetry s = {(uint16_t)i, uniform(-90, 90), uniform(-180, 180), rand() % 31 + 1, rand() % 12 + 1, 2025,
+                       rand() % 24, rand() % 60, rand() % 60, uniform(0, 300), uniform(0, 360),
+                       uniform(-100, 40000), (uint32_t)(rand() % 20), uniform(300, 1100), uniform(-40, 85)};
+        uint8_t frame[TelemetryFrame::SIZE];
+        TelemetryFrame::serialize(s, frame, sizeof(frame));
+        TelemetryFrame::parse(frame, sizeof(frame), samples[i]);
+    }
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        char expected[TelemetryFrame::TEXT_SIZE], text[TelemetryFrame::TEXT_SIZE];
+        printfLine(samples[i], expected, sizeof(expected));
+        TelemetryFrame::format(samples[i], text, sizeof(text));
+        if (strcmp(expected, text) != 0 || concatLine(samples[i]) != expected) {
+            if (mismatches++ < 5) {
+                fprintf(stderr, "mismatch:\n  %s\n  %s\n", expected, text);
+            }
+        }
+    }
+    if (mismatches > 0) {
+        fprintf(stderr, "%zu of %zu lines differ from snprintf\n", mismatches, n);
+        return 1;
+    }
+
+    size_t sink = 0;
+    bench_clock::time_point start = bench_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < n; i++) {
+            sink += concatLine(samples[i]).size();
+        }
+    }
+    double concat = elapsed_ns(start) / (n * rounds);
+
+    char text[TelemetryFrame::TEXT_SIZE];
+    start = bench_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < n; i++) {
+            sink += printfLine(samples[i], text, sizeof(text));
+        }
+    }
+    double printfTime = elapsed_ns(start) / (n * rounds);
+
+    start = bench_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < n; i++) {
+            sink += TelemetryFrame::format(samples[i], text, sizeof(text));
+        }
+    }
+    double format = elapsed_ns(start) / (n * rounds);
+
+    printf("%zu lines match snprintf\n", n);
+    printf("String concat: %8.1f ns/frame\n", concat);
+    printf("snprintf:      %8.1f ns/frame\n", printfTime);
+    printf("format:        %8.1f ns/frame  (%.1fx String concat)\n", format, concat / format);
+    return sink == 0;
+}
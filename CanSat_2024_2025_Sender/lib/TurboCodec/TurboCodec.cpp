@@ -1,41 +1,163 @@
 #include "TurboCodec.h"
 #include <algorithm>
 #include <random>
+#include <climits>
+#include <cstring>
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+
+// Host stand-in for the Arduino micros(), times the decoder
+static uint32_t micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
 
 // ConvolutionalCode Implementation
-ConvolutionalCode::ConvolutionalCode(uint32_t gen) : state(0), generator(gen) {}
+ConvolutionalCode::ConvolutionalCode(uint32_t gen) : state(0), generator(gen) {
+    // Run the bit-serial encoder once over every state and input byte
+    for (uint32_t s = 0; s < STATES; s++) {
+        for (uint32_t b = 0; b < 256; b++) {
+            uint32_t st = s;
+            uint8_t p = 0;
+            for (int i = 7; i >= 0; --i) {
+                uint8_t u = (b >> i) & 1;
+                p = (p << 1) | parity(st, u);
+                st = nextState(st, u);
+            }
+            byteParity[s][b] = p;
+        }
+    }
+}
 
 void ConvolutionalCode::reset() {
     state = 0;
 }
 
 uint8_t ConvolutionalCode::computeParity(uint8_t input) {
-    uint32_t temp = (state << 1) | input;
-    uint8_t parity = 0;
+    uint8_t p = parity(state, input);
+    state = nextState(state, input); // Update state
+    return p;
+}
+
+uint8_t ConvolutionalCode::encodeByte(uint8_t input) {
+    uint8_t p = byteParity[state][input];
+    state = input & (STATES - 1); // The code is not recursive, the last MEMORY input bits are the state
+    return p;
+}
+
+uint8_t ConvolutionalCode::parity(uint32_t from, uint8_t input) const {
+    uint32_t temp = (from << 1) | input;
+    uint8_t p = 0;
 
     for (uint8_t i = 0; i <= MEMORY; i++) {
         if ((temp & (generator << i)) != 0) {
-            parity ^= 1;
+            p ^= 1;
+        }
+    }
+    return p;
+}
+
+uint32_t ConvolutionalCode::nextState(uint32_t from, uint8_t input) {
+    return ((from << 1) | input) & (STATES - 1);
+}
+
+// Spreads the bits of a byte to every third bit of a 24-bit word, MSB first,
+// which interleaves the systematic and parity bytes into three output bytes
+struct SpreadTable {
+    uint32_t bits[256];
+    constexpr SpreadTable() : bits() {
+        for (uint32_t b = 0; b < 256; b++) {
+            for (uint32_t i = 0; i < 8; i++) {
+                bits[b] |= ((b >> (7 - i)) & 1) << (23 - 3 * i);
+            }
         }
     }
-    state = temp & ((1 << MEMORY) - 1); // Update state
-    return parity;
+};
+static constexpr SpreadTable SPREAD;
+
+// Data bits of a byte (MSB first) whose parity 1 and parity 2 bits survive puncturing, per rate
+static const uint8_t KEEP_PARITY1[TurboCodec::PUNCTURING_COUNT] = {0xFF, 0xAA, 0x88};
+static const uint8_t KEEP_PARITY2[TurboCodec::PUNCTURING_COUNT] = {0xFF, 0x55, 0x22};
+
+// Checks if the parity bit of data bit i survives puncturing
+static bool kept(const uint8_t *keep, TurboCodec::Puncturing rate, size_t i) {
+    return (keep[rate] >> (7 - (i & 7))) & 1;
 }
 
 // TurboCodec Implementation
-TurboCodec::TurboCodec() {}
+TurboCodec::TurboCodec() : encoder1(0b1011), encoder2(0b1111), interleaverLookups(0) {
+    for (InterleaverSlot &slot : interleavers) {
+        slot.length = 0;
+        slot.lastUse = 0;
+    }
+    resetCounters();
+}
+
+void TurboCodec::resetCounters() {
+    memset(&decodeCounters, 0, sizeof(decodeCounters));
+}
+
+uint16_t TurboCodec::crc16(const uint8_t *data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; ++b) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+bool TurboCodec::crcMatches(const uint8_t *bits, size_t dataBits) {
+    // Running the CRC on over the appended CRC leaves 0
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < dataBits; ++i) {
+        bool top = ((crc >> 15) ^ bits[i]) & 1;
+        crc <<= 1;
+        if (top) {
+            crc ^= 0x1021;
+        }
+    }
+    return crc == 0;
+}
 
-std::vector<size_t> TurboCodec::generateInterleaver(size_t length) {
-    std::vector<size_t> interleaver(length);
+void TurboCodec::fillInterleaver(uint16_t *interleaver, size_t length) {
     for (size_t i = 0; i < length; ++i) {
         interleaver[i] = i;
     }
 
     // Use Mersenne Twister with fixed seed 42 for reproducibility
     std::mt19937 generator(42);
-    std::shuffle(interleaver.begin(), interleaver.end(), generator);
+    std::shuffle(interleaver, interleaver + length, generator);
+}
+
+const uint16_t *TurboCodec::interleaverFor(size_t length, std::vector<uint16_t> &uncached) {
+    if (length > MAX_DATA_BITS) {
+        uncached.resize(length);
+        fillInterleaver(uncached.data(), length);
+        return uncached.data();
+    }
+
+    // Telemetry frames only take a few lengths, so the shuffle runs once per length
+    interleaverLookups++;
+    InterleaverSlot *oldest = &interleavers[0];
+    for (InterleaverSlot &slot : interleavers) {
+        if (slot.length == length) {
+            slot.lastUse = interleaverLookups;
+            return slot.table;
+        }
+        if (slot.lastUse < oldest->lastUse) {
+            oldest = &slot;
+        }
+    }
 
-    return interleaver;
+    fillInterleaver(oldest->table, length);
+    oldest->length = length;
+    oldest->lastUse = interleaverLookups;
+    return oldest->table;
 }
 
 std::vector<uint8_t> TurboCodec::stringToBinary(const std::string &input) {
@@ -60,17 +182,16 @@ std::string TurboCodec::binaryToString(const std::vector<uint8_t> &binary) {
     return output;
 }
 
-std::string TurboCodec::encode(const std::string &input) {
-    // Convert input string to binary
-    auto binaryInput = stringToBinary(input);
-
-    // Generate interleaver
-    auto interleaver = generateInterleaver(binaryInput.size());
+std::string TurboCodec::encode(const std::string &input, Puncturing rate) {
+    // Append the CRC and convert to binary
+    uint16_t crc = crc16((const uint8_t *)input.data(), input.size());
+    auto binaryInput = stringToBinary(input + (char)(crc >> 8) + (char)(crc & 0xFF));
 
-    // Initialize encoders
-    ConvolutionalCode encoder1(0b1011); // Generator polynomial 1
-    ConvolutionalCode encoder2(0b1111); // Generator polynomial 2
+    // Look up the interleaver of this length
+    std::vector<uint16_t> uncached;
+    const uint16_t *interleaver = interleaverFor(binaryInput.size(), uncached);
 
+    // Reset the encoders, this path stays bit-serial as the reference of the packed encoder
     encoder1.reset();
     encoder2.reset();
 
@@ -92,13 +213,302 @@ std::string TurboCodec::encode(const std::string &input) {
         parity2[i] = encoder2.computeParity(permutedInput[i]);
     }
 
-    // Combine systematic, parity1, and parity2 bits into the final encoded output
+    // Combine systematic, and the parity1 and parity2 bits left by puncturing into the final encoded output
     std::string encodedOutput;
     for (size_t i = 0; i < binaryInput.size(); ++i) {
         encodedOutput += (binaryInput[i] ? '1' : '0');
-        encodedOutput += (parity1[i] ? '1' : '0');
-        encodedOutput += (parity2[i] ? '1' : '0');
+        if (kept(KEEP_PARITY1, rate, i)) {
+            encodedOutput += (parity1[i] ? '1' : '0');
+        }
+        if (kept(KEEP_PARITY2, rate, i)) {
+            encodedOutput += (parity2[i] ? '1' : '0');
+        }
+    }
+
+    // Terminate both trellises with zero bits, only their parity bits are sent
+    std::string tail2;
+    for (uint32_t t = 0; t < ConvolutionalCode::TAIL_BITS; ++t) {
+        encodedOutput += (encoder1.computeParity(0) ? '1' : '0');
+        tail2 += (encoder2.computeParity(0) ? '1' : '0');
     }
+    encodedOutput += tail2;
 
     return encodedOutput;
 }
+
+size_t TurboCodec::encode(const uint8_t *input, size_t length, uint8_t *output, size_t outputSize,
+                          Puncturing rate) {
+    if (length > MAX_INPUT_BYTES || rate >= PUNCTURING_COUNT || outputSize < (encodedBits(length, rate) + 7) / 8) {
+        return 0;
+    }
+
+    // The message and its CRC are encoded as one block
+    uint8_t data[MAX_INPUT_BYTES + CRC_BYTES];
+    memcpy(data, input, length);
+    uint16_t crc = crc16(input, length);
+    data[length++] = crc >> 8;
+    data[length++] = crc & 0xFF;
+
+    size_t dataBits = length * 8;
+    std::vector<uint16_t> uncached; // Stays empty, the length fits the cache
+    const uint16_t *interleaver = interleaverFor(dataBits, uncached);
+
+    encoder1.reset();
+    encoder2.reset();
+
+    // Coded bits are shifted MSB first through an accumulator into the output bytes
+    uint8_t *out = output;
+    uint32_t pending = 0;
+    size_t pendingBits = 0;
+    auto put = [&](uint32_t bits, size_t count) {
+        pending = (pending << count) | bits;
+        pendingBits += count;
+        while (pendingBits >= 8) {
+            pendingBits -= 8;
+            *out++ = pending >> pendingBits;
+        }
+    };
+
+    for (size_t k = 0; k < length; ++k) {
+        uint8_t permuted = 0;
+        for (size_t i = 8 * k; i < 8 * k + 8; ++i) {
+            size_t j = interleaver[i];
+            permuted = (permuted << 1) | ((data[j >> 3] >> (7 - (j & 7))) & 1);
+        }
+        uint8_t sys = data[k];
+        uint8_t p1 = encoder1.encodeByte(sys);
+        uint8_t p2 = encoder2.encodeByte(permuted);
+
+        if (rate == RATE_1_3) {
+            // Nothing punctured, the three bytes spread into three output bytes
+            put(SPREAD.bits[sys] | (SPREAD.bits[p1] >> 1) | (SPREAD.bits[p2] >> 2), 24);
+            continue;
+        }
+
+        uint32_t coded = 0;
+        size_t count = 0;
+        for (int i = 7; i >= 0; --i) {
+            coded = (coded << 1) | ((sys >> i) & 1);
+            count++;
+            if ((KEEP_PARITY1[rate] >> i) & 1) {
+                coded = (coded << 1) | ((p1 >> i) & 1);
+                count++;
+            }
+            if ((KEEP_PARITY2[rate] >> i) & 1) {
+                coded = (coded << 1) | ((p2 >> i) & 1);
+                count++;
+            }
+        }
+        put(coded, count);
+    }
+
+    // Terminate both trellises with zero bits, only their parity bits are sent
+    uint32_t tail1 = 0, tail2 = 0;
+    for (uint32_t t = 0; t < ConvolutionalCode::TAIL_BITS; ++t) {
+        tail1 = (tail1 << 1) | encoder1.computeParity(0);
+        tail2 = (tail2 << 1) | encoder2.computeParity(0);
+    }
+    put(tail1, ConvolutionalCode::TAIL_BITS);
+    put(tail2, ConvolutionalCode::TAIL_BITS);
+    if (pendingBits > 0) {
+        *out = pending << (8 - pendingBits);
+    }
+
+    return encodedBits(length - CRC_BYTES, rate);
+}
+
+// Clamps an LLR so the metrics stay inside int32 over long frames
+static int32_t saturate(int32_t x) {
+    if (x > TurboCodec::LLR_LIMIT) return TurboCodec::LLR_LIMIT;
+    if (x < -TurboCodec::LLR_LIMIT) return -TurboCodec::LLR_LIMIT;
+    return x;
+}
+
+void TurboCodec::maxLogMap(const ConvolutionalCode &code, const int32_t *systematic, const int32_t *parity,
+                           const int32_t *apriori, int32_t *extrinsic, size_t length) {
+    const uint32_t S = ConvolutionalCode::STATES;
+    const int32_t NEG = INT32_MIN / 4;
+
+    // Branch tables of the trellis, the code is not recursive so they hold for every step
+    uint8_t next[S][2], out[S][2];
+    for (uint32_t s = 0; s < S; s++) {
+        for (uint8_t u = 0; u < 2; u++) {
+            next[s][u] = ConvolutionalCode::nextState(s, u);
+            out[s][u] = code.parity(s, u);
+        }
+    }
+
+    // Forward metrics, the encoder starts in state 0
+    alpha.assign((length + 1) * S, NEG);
+    alpha[0] = 0;
+    for (size_t k = 0; k < length; k++) {
+        const int32_t *a = &alpha[k * S];
+        int32_t *an = &alpha[(k + 1) * S];
+        const int32_t lu = systematic[k] + apriori[k];
+        for (uint32_t s = 0; s < S; s++) {
+            if (a[s] == NEG) continue;
+            for (uint8_t u = 0; u < 2; u++) {
+                int32_t m = a[s] + (u ? lu : 0) + (out[s][u] ? parity[k] : 0);
+                if (m > an[next[s][u]]) an[next[s][u]] = m;
+            }
+        }
+        // Normalize against the best state so the metrics never grow
+        int32_t best = NEG;
+        for (uint32_t s = 0; s < S; s++) if (an[s] > best) best = an[s];
+        for (uint32_t s = 0; s < S; s++) if (an[s] != NEG) an[s] -= best;
+    }
+
+    // Backward metrics, the tail bits terminate the trellis in state 0
+    int32_t beta[S], betaPrev[S];
+    for (uint32_t s = 0; s < S; s++) beta[s] = s == 0 ? 0 : NEG;
+
+    for (size_t k = length; k-- > 0;) {
+        const int32_t *a = &alpha[k * S];
+        const int32_t lu = systematic[k] + apriori[k];
+        int32_t best1 = NEG, best0 = NEG;
+
+        for (uint32_t s = 0; s < S; s++) {
+            int32_t b = NEG;
+            for (uint8_t u = 0; u < 2; u++) {
+                int32_t g = (u ? lu : 0) + (out[s][u] ? parity[k] : 0);
+                int32_t bs = g + beta[next[s][u]];
+                if (bs > b) b = bs;
+                if (a[s] != NEG) {
+                    int32_t m = a[s] + bs;
+                    if (u) { if (m > best1) best1 = m; }
+                    else   { if (m > best0) best0 = m; }
+                }
+            }
+            betaPrev[s] = b;
+        }
+
+        // Extrinsic part only, scaled by 3/4 to offset the max-log approximation
+        int32_t llr = best1 - best0 - systematic[k] - apriori[k];
+        extrinsic[k] = saturate((llr * 3) / 4);
+
+        int32_t best = NEG;
+        for (uint32_t s = 0; s < S; s++) if (betaPrev[s] > best) best = betaPrev[s];
+        for (uint32_t s = 0; s < S; s++) beta[s] = betaPrev[s] - best;
+    }
+}
+
+void TurboCodec::depuncture(const int16_t *llr, size_t dataBits, Puncturing rate,
+                            int16_t *sys, int16_t *par1, int16_t *par2) {
+    const int16_t *in = llr;
+    for (size_t i = 0; i < dataBits; ++i) {
+        sys[i] = *in++;
+        par1[i] = kept(KEEP_PARITY1, rate, i) ? *in++ : 0;
+        par2[i] = kept(KEEP_PARITY2, rate, i) ? *in++ : 0;
+    }
+
+    // The tail bits are known zeros, only their parity bits were sent
+    for (size_t t = dataBits; t < dataBits + ConvolutionalCode::TAIL_BITS; ++t) {
+        sys[t] = -LLR_LIMIT;
+        par1[t] = *in++;
+    }
+    for (size_t t = dataBits; t < dataBits + ConvolutionalCode::TAIL_BITS; ++t) {
+        par2[t] = *in++;
+    }
+}
+
+bool TurboCodec::decodeSoft(const int16_t *llr, size_t dataBits, uint8_t *output, Puncturing rate,
+                            int iterations) {
+    uint32_t start = micros();
+    const uint16_t *interleaver = interleaverFor(dataBits, uncachedInterleaver);
+
+    // Both trellises run on past the data through the tail bits
+    const size_t length = dataBits + ConvolutionalCode::TAIL_BITS;
+
+    // Split the channel LLRs, the second decoder sees the systematic bits in interleaved order
+    channel.resize(3 * length);
+    depuncture(llr, dataBits, rate, &channel[0], &channel[length], &channel[2 * length]);
+
+    const int16_t *split = channel.data();
+    sys.assign(split, split + length);
+    par1.assign(split + length, split + 2 * length);
+    par2.assign(split + 2 * length, split + 3 * length);
+    sysPerm.assign(sys.begin(), sys.end());
+    for (size_t i = 0; i < dataBits; ++i) {
+        sysPerm[i] = sys[interleaver[i]];
+    }
+
+    // A clean frame passes the CRC on the channel decisions alone
+    for (size_t i = 0; i < dataBits; ++i) {
+        output[i] = sys[i] > 0 ? 1 : 0;
+    }
+    bool passed = crcMatches(output, dataBits);
+
+    // Every half-iteration ends with an a-posteriori decision (channel, plus the extrinsic information
+    // of both decoders) and stops once the CRC matches
+    apriori1.assign(length, 0);
+    apriori2.assign(length, 0);
+    extrinsic1.resize(length);
+    extrinsic2.resize(length);
+    uint32_t halfIterations = 0;
+    for (int it = 0; it < iterations && !passed; ++it) {
+        maxLogMap(encoder1, sys.data(), par1.data(), apriori1.data(), extrinsic1.data(), length);
+        halfIterations++;
+        for (size_t i = 0; i < dataBits; ++i) {
+            output[i] = (sys[i] + extrinsic1[i] + apriori1[i]) > 0 ? 1 : 0;
+        }
+        if ((passed = crcMatches(output, dataBits))) {
+            break;
+        }
+
+        for (size_t i = 0; i < dataBits; ++i) {
+            apriori2[i] = extrinsic1[interleaver[i]];
+        }
+        maxLogMap(encoder2, sysPerm.data(), par2.data(), apriori2.data(), extrinsic2.data(), length);
+        halfIterations++;
+        for (size_t i = 0; i < dataBits; ++i) {
+            output[interleaver[i]] = (sysPerm[i] + apriori2[i] + extrinsic2[i]) > 0 ? 1 : 0;
+        }
+        passed = crcMatches(output, dataBits);
+
+        for (size_t i = 0; i < dataBits; ++i) {
+            apriori1[interleaver[i]] = extrinsic2[i];
+        }
+    }
+
+    uint32_t elapsed = micros() - start;
+    decodeCounters.frames++;
+    decodeCounters.crcPassed += passed ? 1 : 0;
+    decodeCounters.halfIterations += halfIterations;
+    decodeCounters.totalMicros += elapsed;
+    if (elapsed > decodeCounters.maxMicros) {
+        decodeCounters.maxMicros = elapsed;
+    }
+    return passed;
+}
+
+std::string TurboCodec::decode(const std::vector<uint8_t> &bits, Puncturing rate, int iterations,
+                               bool *crcPassed) {
+    if (crcPassed) {
+        *crcPassed = false;
+    }
+
+    // Whole bytes only, as many as the coded bits hold next to the tail
+    if (rate >= PUNCTURING_COUNT || bits.size() <= TAIL_BITS) {
+        return std::string();
+    }
+    size_t dataBytes = (bits.size() - TAIL_BITS) / codedBitsPerByte(rate);
+    if (dataBytes <= CRC_BYTES) {
+        return std::string();
+    }
+    size_t dataBits = dataBytes * 8;
+
+    std::vector<int16_t> llr(encodedBits(dataBytes - CRC_BYTES, rate));
+    for (size_t i = 0; i < llr.size(); ++i) {
+        llr[i] = bits[i] ? HARD_BIT_LLR : -HARD_BIT_LLR;
+    }
+
+    std::vector<uint8_t> decoded(dataBits);
+    bool passed = decodeSoft(llr.data(), dataBits, decoded.data(), rate, iterations);
+    if (crcPassed) {
+        *crcPassed = passed;
+    }
+
+    // Drop the CRC
+    decoded.resize(dataBits - CRC_BYTES * 8);
+    return binaryToString(decoded);
+}
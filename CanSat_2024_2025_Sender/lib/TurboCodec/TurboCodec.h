@@ -12,22 +12,136 @@ private:
     uint32_t generator;              // Generator parameter
     static constexpr uint32_t MEMORY = 3; // Memory of the encoder
 
+public:
+    static constexpr uint32_t STATES = 1 << MEMORY; // Trellis states
+    static constexpr uint32_t TAIL_BITS = MEMORY;   // Zero input bits that return the encoder to state 0
+
+private:
+    uint8_t byteParity[STATES][256]; // Parity bits of every state and input byte, MSB first
+
 public:
     ConvolutionalCode(uint32_t gen); // Constructor with generator polynomial
     void reset();                    // Reset encoder state
-    uint8_t computeParity(uint8_t input); // Compute parity bit for the input
+    uint8_t computeParity(uint8_t input); // Compute parity bit for the input, bit-serial reference
+    uint8_t encodeByte(uint8_t input); // Parity bits of 8 input bits (MSB first) with one table lookup
+    uint8_t parity(uint32_t from, uint8_t input) const; // Parity bit of one trellis branch
+    static uint32_t nextState(uint32_t from, uint8_t input); // Target state of one trellis branch
 };
 
-// TurboCodec class
+// TurboCodec class, holds about 12 KB of tables and the decoder workspace: keep instances global or
+// static, and decode on one task per instance
 class TurboCodec {
 public:
+    // Puncturing patterns, every systematic bit is always sent
+    enum Puncturing : uint8_t {
+        RATE_1_3 = 0, // Parity 1 and parity 2 of every data bit
+        RATE_1_2 = 1, // Parity 1 of even, parity 2 of odd data bits
+        RATE_2_3 = 2, // Parity 1 of every fourth data bit, parity 2 two bits later
+    };
+    static constexpr uint8_t PUNCTURING_COUNT = 3; // Number of puncturing patterns
+
+    static constexpr int DEFAULT_ITERATIONS = 6;  // Decoder iterations when none is given
+    static constexpr int16_t HARD_BIT_LLR = 32;   // Channel LLR given to a hard-decision bit
+    static constexpr int32_t LLR_LIMIT = 4096;    // Saturation of the a-priori and extrinsic LLRs
+    static constexpr size_t MAX_INPUT_BYTES = 128; // Largest message the packed encoder accepts
+    static constexpr size_t INTERLEAVER_SLOTS = 4; // Frame lengths kept in the interleaver cache
+    static constexpr size_t TAIL_BITS = 2 * ConvolutionalCode::TAIL_BITS; // Tail parity bits of both encoders
+    static constexpr size_t CRC_BYTES = 2;         // CRC-16 appended to every message before encoding
+
+    // Decoder counters since the last resetCounters, latency as measured around decodeSoft
+    struct DecodeCounters {
+        uint32_t frames;          // Frames decoded
+        uint32_t crcPassed;       // Frames whose CRC matched
+        uint32_t halfIterations;  // Half-iterations run over all frames
+        uint32_t totalMicros;     // Decode time of all frames
+        uint32_t maxMicros;       // Longest decode of a single frame
+    };
+
+    // Coded bits per data byte, systematic and unpunctured parity bits
+    static constexpr size_t codedBitsPerByte(Puncturing rate) {
+        return rate == RATE_1_3 ? 24 : rate == RATE_1_2 ? 16 : 12;
+    }
+
+    // Coded bits of a message of length bytes, CRC and tail included
+    static constexpr size_t encodedBits(size_t length, Puncturing rate) {
+        return codedBitsPerByte(rate) * (length + CRC_BYTES) + TAIL_BITS;
+    }
+
+    // Bytes needed for the packed encoding of a message at any rate
+    static constexpr size_t encodedBytes(size_t length) { return (encodedBits(length, RATE_1_3) + 7) / 8; }
+
     TurboCodec();                    // Constructor for the TurboCodec
-    std::string encode(const std::string &input); // Turbo encoding for a string
+    std::string encode(const std::string &input, Puncturing rate = RATE_1_3); // Turbo encoding for a string
+
+    // Turbo encoding into packed bytes, MSB first: per bit of the message and its CRC the systematic bit
+    // and the parity bits kept by rate, then the tail parity bits of encoder 1 and encoder 2.
+    // Returns the bit length, or 0 if the message is longer than MAX_INPUT_BYTES or does not fit in output
+    size_t encode(const uint8_t *input, size_t length, uint8_t *output, size_t outputSize,
+                  Puncturing rate = RATE_1_3);
+
+    // Turbo decoding of hard-decision bits in the order written by encode, returns the message without
+    // its CRC. crcPassed, if given, tells if the CRC matched
+    std::string decode(const std::vector<uint8_t> &bits, Puncturing rate = RATE_1_3,
+                       int iterations = DEFAULT_ITERATIONS, bool *crcPassed = nullptr);
+
+    // Turbo decoding of channel LLRs (positive means 1) in the order written by encode, one decided bit
+    // per data bit in output. dataBits counts the message and CRC bits, llr holds
+    // encodedBits(dataBits / 8 - CRC_BYTES, rate) values. Stops as soon as the CRC matches after a
+    // half-iteration, at most iterations full iterations. Returns true if the CRC matched
+    bool decodeSoft(const int16_t *llr, size_t dataBits, uint8_t *output, Puncturing rate = RATE_1_3,
+                    int iterations = DEFAULT_ITERATIONS);
+
+    const DecodeCounters &counters() const { return decodeCounters; } // Decoder counters
+    void resetCounters();                                              // Clears the decoder counters
+
+    // CRC-16/CCITT-FALSE of a byte buffer, appended MSB first by encode
+    static uint16_t crc16(const uint8_t *data, size_t length);
+
+    // Checks the CRC of decided bits (one per byte, MSB first) holding a message and its CRC
+    static bool crcMatches(const uint8_t *bits, size_t dataBits);
+
+    // Splits channel LLRs in the order written by encode into the systematic, parity 1 and parity 2
+    // LLRs of the dataBits + ConvolutionalCode::TAIL_BITS trellis steps. Punctured parity bits get LLR 0,
+    // the tail systematic bits are known zeros
+    static void depuncture(const int16_t *llr, size_t dataBits, Puncturing rate,
+                           int16_t *sys, int16_t *par1, int16_t *par2);
 
 private:
-    std::vector<size_t> generateInterleaver(size_t length); // Generate interleaver
+    friend class TurboWindowDecoder; // Shares the constituent codes and the interleaver cache
+
+    // Max-log-MAP (BCJR) pass over one constituent code, fixed point
+    void maxLogMap(const ConvolutionalCode &code, const int32_t *systematic, const int32_t *parity,
+                   const int32_t *apriori, int32_t *extrinsic, size_t length);
+
+    // Interleaver of one frame length, shuffled on first use and cached per length.
+    // Lengths above MAX_DATA_BITS are shuffled into uncached on every call
+    const uint16_t *interleaverFor(size_t length, std::vector<uint16_t> &uncached);
+    void fillInterleaver(uint16_t *interleaver, size_t length); // Generate interleaver into a buffer
     std::vector<uint8_t> stringToBinary(const std::string &input); // Convert string to binary
     std::string binaryToString(const std::vector<uint8_t> &binary); // Convert binary to string
+
+    static constexpr size_t MAX_DATA_BITS = (MAX_INPUT_BYTES + CRC_BYTES) * 8; // Longest cached interleaver
+
+    // One cached interleaver table
+    struct InterleaverSlot {
+        uint16_t length;                      // Data bits of the table, 0 while the slot is empty
+        uint32_t lastUse;                     // Lookup counter at the last use, the oldest slot is replaced
+        uint16_t table[MAX_DATA_BITS];        // Permutation, output position to input bit
+    };
+
+    ConvolutionalCode encoder1;                      // Constituent code of the data in order
+    ConvolutionalCode encoder2;                      // Constituent code of the interleaved data
+    InterleaverSlot interleavers[INTERLEAVER_SLOTS]; // Interleaver cache
+    uint32_t interleaverLookups;                     // Lookups so far, orders the slots by last use
+    DecodeCounters decodeCounters;                   // Decoder counters
+
+    // Decoder workspace, grown to the longest frame and then reused so decodeSoft does not allocate
+    std::vector<uint16_t> uncachedInterleaver;       // Interleaver of a frame longer than MAX_DATA_BITS
+    std::vector<int16_t> channel;                    // Depunctured LLRs: systematic, parity 1, parity 2
+    std::vector<int32_t> sys, sysPerm, par1, par2;   // Channel LLRs widened, sysPerm in interleaved order
+    std::vector<int32_t> apriori1, extrinsic1;       // A-priori and extrinsic LLRs of decoder 1
+    std::vector<int32_t> apriori2, extrinsic2;       // A-priori and extrinsic LLRs of decoder 2
+    std::vector<int32_t> alpha;                      // Forward metrics of maxLogMap, [step][state]
 };
 
 #endif // TURBO_CODEC_H
@@ -0,0 +1,124 @@
+/* Host benchmark for TurboWindowDecoder, not an Arduino sketch.
+ * It sits under examples/ so the firmware build leaves it out.
+ *
+ * Build and run from this directory:
+ *   g++ -O3 -DNDEBUG -mavx2 -pthread -I../.. turbo_window_benchmark.cpp ../../TurboCodec.cpp \
+ *       ../../TurboWindowDecoder.cpp -o turbo_window_benchmark && ./turbo_window_benchmark
+ * Without -mavx2 only the scalar reference runs. The AVX2 output must be bit-exact with it. */
+
+#include "TurboWindowDecoder.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static const size_t MSG_LEN = 96;
+static const size_t DATA_BITS = (MSG_LEN + TurboCodec::CRC_BYTES) * 8; // Message and CRC
+static const size_t FRAMES = 200;
+static const double FLIP = 0.03; // Channel bit error rate
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double elapsed_ns(bench_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+}
+
+/* Encodes FRAMES random messages and turns the coded bits into hard-decision LLRs with FLIP errors */
+static void make_frames(TurboCodec &codec, TurboCodec::Puncturing rate,
+                        std::vector<uint8_t> &msgs, std::vector<int16_t> &llrs, size_t &coded) {
+    coded = TurboCodec::encodedBits(MSG_LEN, rate);
+    msgs.resize(FRAMES * MSG_LEN);
+    llrs.resize(FRAMES * coded);
+    for(size_t i = 0; i < msgs.size(); i++) msgs[i] = rand();
+
+    uint8_t out[TurboCodec::encodedBytes(MSG_LEN)];
+    for(size_t f = 0; f < FRAMES; f++) {
+        codec.encode(&msgs[f * MSG_LEN], MSG_LEN, out, sizeof(out), rate);
+        for(size_t i = 0; i < coded; i++) {
+            bool bit = (out[i / 8] >> (7 - i % 8)) & 1;
+            if(rand() < FLIP * RAND_MAX) bit = !bit;
+            llrs[f * coded + i] = bit ? TurboCodec::HARD_BIT_LLR : -TurboCodec::HARD_BIT_LLR;
+        }
+    }
+}
+
+/* Bit error rate of the decoded messages, CRC left out */
+static double bit_error_rate(const std::vector<uint8_t> &msgs, const std::vector<uint8_t> &bits) {
+    size_t errors = 0;
+    for(size_t f = 0; f < FRAMES; f++) {
+        for(size_t i = 0; i < MSG_LEN * 8; i++) {
+            errors += bits[f * DATA_BITS + i] != ((msgs[f * MSG_LEN + i / 8] >> (7 - i % 8)) & 1);
+        }
+    }
+    return (double)errors / (FRAMES * MSG_LEN * 8);
+}
+
+int main() {
+    srand(1);
+    TurboCodec codec;
+    TurboWindowDecoder decoder(codec);
+    const bool simd = TurboWindowDecoder::simdAvailable();
+
+    for(uint8_t r = 0; r < TurboCodec::PUNCTURING_COUNT; r++) {
+        TurboCodec::Puncturing rate = (TurboCodec::Puncturing)r;
+        std::vector<uint8_t> msgs;
+        std::vector<int16_t> llrs;
+        size_t coded;
+        make_frames(codec, rate, msgs, llrs, coded);
+
+        std::vector<uint8_t> full(FRAMES * DATA_BITS), scalar(FRAMES * DATA_BITS), avx2(FRAMES * DATA_BITS);
+
+        bench_clock::time_point t = bench_clock::now();
+        for(size_t f = 0; f < FRAMES; f++) codec.decodeSoft(&llrs[f * coded], DATA_BITS, &full[f * DATA_BITS], rate);
+        double full_ns = elapsed_ns(t) / FRAMES;
+
+        t = bench_clock::now();
+        for(size_t f = 0; f < FRAMES; f++) {
+            decoder.decode(&llrs[f * coded], DATA_BITS, &scalar[f * DATA_BITS], rate, TurboCodec::DEFAULT_ITERATIONS, false);
+        }
+        double scalar_ns = elapsed_ns(t) / FRAMES;
+
+        double avx2_ns = 0;
+        if(simd) {
+            t = bench_clock::now();
+            for(size_t f = 0; f < FRAMES; f++) decoder.decode(&llrs[f * coded], DATA_BITS, &avx2[f * DATA_BITS], rate);
+            avx2_ns = elapsed_ns(t) / FRAMES;
+
+            if(avx2 != scalar) {
+                printf("AVX2 decoder output differs from the scalar reference at rate %u!\n", r);
+                return 1;
+            }
+        }
+
+        /* Decoded Mbit/s = data bits per microsecond */
+        printf("rate %u, %zu-byte frames, BER %.2f: decodeSoft %6.2f Mbit/s (BER %.5f)  windowed scalar %6.2f Mbit/s",
+               r, MSG_LEN, FLIP, DATA_BITS * 1e3 / full_ns, bit_error_rate(msgs, full), DATA_BITS * 1e3 / scalar_ns);
+        if(simd) printf("  AVX2 %6.2f Mbit/s", DATA_BITS * 1e3 / avx2_ns);
+        printf(" (BER %.5f)\n", bit_error_rate(msgs, scalar));
+    }
+
+    /* Several receivers' streams at once: one codec and decoder per thread */
+    unsigned threads = std::thread::hardware_concurrency();
+    if(threads == 0) threads = 1;
+    std::vector<uint8_t> msgs;
+    std::vector<int16_t> llrs;
+    size_t coded;
+    make_frames(codec, TurboCodec::RATE_1_3, msgs, llrs, coded);
+
+    bench_clock::time_point t = bench_clock::now();
+    std::vector<std::thread> pool;
+    for(unsigned i = 0; i < threads; i++) {
+        pool.emplace_back([&]() {
+            TurboCodec own;
+            TurboWindowDecoder threadDecoder(own);
+            std::vector<uint8_t> bits(DATA_BITS);
+            for(size_t f = 0; f < FRAMES; f++) threadDecoder.decode(&llrs[f * coded], DATA_BITS, bits.data());
+        });
+    }
+    for(std::thread &thread : pool) thread.join();
+    double total_ns = elapsed_ns(t);
+    printf("%u threads: %6.2f Mbit/s\n", threads, threads * FRAMES * DATA_BITS * 1e3 / total_ns);
+    return 0;
+}
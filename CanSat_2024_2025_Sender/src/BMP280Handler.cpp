@@ -27,6 +27,11 @@ void BMP280Handler::begin() {
         Serial.println("BMP280 Initialization Failed"); // Log failure message
         while (1); // Halt execution if initialization fails
     }
+
+    // Continuous measurements every ~26 ms (x8 pressure, x2 temperature oversampling, 1 ms standby),
+    // faster than the PressureSampler slots so every slot reads a fresh value
+    bmp.setSampling(Adafruit_BMP280::MODE_NORMAL, Adafruit_BMP280::SAMPLING_X2, Adafruit_BMP280::SAMPLING_X8,
+                    Adafruit_BMP280::FILTER_X4, Adafruit_BMP280::STANDBY_MS_1);
     Serial.println("BMP280 Initialized"); // Log success message
 }
 
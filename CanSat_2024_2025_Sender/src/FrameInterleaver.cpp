@@ -0,0 +1,90 @@
+#include "FrameInterleaver.hpp"
+
+/**
+ * @brief Constructor for FrameInterleaver.
+ *
+ * @param depth Number of frames interleaved together, clamped to 1..MAX_DEPTH.
+ */
+FrameInterleaver::FrameInterleaver(uint8_t depth)
+    : depth(depth < 1 ? 1 : (depth > MAX_DEPTH ? MAX_DEPTH : depth)), frames(0), groupId(0), slotLength(0), packets(0) {}
+
+/**
+ * @brief Adds one encoded frame to the group.
+ *
+ * Once `depth` frames are collected the codewords are padded with zeros to the
+ * longest one, interleaved, and the packet count is worked out.
+ *
+ * @param frame Pointer to the encoded frame.
+ * @param length Length of the encoded frame in bytes.
+ * @return True when the group is complete.
+ */
+bool FrameInterleaver::addFrame(const char* frame, size_t length) {
+    if (frames >= depth || length <= FRAME_HEADER_SIZE || length - FRAME_HEADER_SIZE > MAX_CODEWORD) {
+        return frames >= depth; // Group already full or frame does not fit
+    }
+
+    memcpy(headers + frames * FRAME_HEADER_SIZE, frame, FRAME_HEADER_SIZE);
+    lengths[frames] = length - FRAME_HEADER_SIZE;
+    memcpy(codewords + frames * MAX_CODEWORD, frame + FRAME_HEADER_SIZE, lengths[frames]);
+    frames++;
+
+    if (frames < depth) {
+        return false;
+    }
+
+    // Pad every codeword to the longest one and lay them out back to back
+    slotLength = 0;
+    for (uint8_t i = 0; i < depth; i++) {
+        if (lengths[i] > slotLength) {
+            slotLength = lengths[i];
+        }
+    }
+    uint8_t slots[MAX_DEPTH * MAX_CODEWORD];
+    memset(slots, 0, depth * slotLength);
+    for (uint8_t i = 0; i < depth; i++) {
+        memcpy(slots + i * slotLength, codewords + i * MAX_CODEWORD, lengths[i]);
+    }
+
+    RS::Interleave(slots, depth, slotLength, stream);
+    packets = (depth * slotLength + MAX_CHUNK - 1) / MAX_CHUNK;
+    return true;
+}
+
+/**
+ * @brief Builds one packet of the complete group.
+ *
+ * The stream is cut into nearly equal chunks so every packet carries about the same airtime.
+ *
+ * @param index Packet index, below packetCount().
+ * @param packet Buffer for the packet.
+ * @return Length of the packet in bytes, 0 if the group is not complete.
+ */
+size_t FrameInterleaver::buildPacket(size_t index, uint8_t* packet) const {
+    if (frames < depth || index >= packets) {
+        return 0;
+    }
+
+    size_t total = depth * slotLength;
+    size_t chunk = (total + packets - 1) / packets;
+    size_t start = index * chunk;
+    size_t end = start + chunk < total ? start + chunk : total;
+
+    packet[0] = groupId;
+    packet[1] = depth;
+    packet[2] = (uint8_t)((index << 4) | packets);
+    packet[3] = (uint8_t)slotLength;
+    memcpy(packet + GROUP_HEADER_SIZE, headers, depth * FRAME_HEADER_SIZE);
+
+    size_t offset = GROUP_HEADER_SIZE + depth * FRAME_HEADER_SIZE;
+    memcpy(packet + offset, stream + start, end - start);
+    return offset + end - start;
+}
+
+/**
+ * @brief Starts the next group after all its packets were sent.
+ */
+void FrameInterleaver::nextGroup() {
+    frames = 0;
+    packets = 0;
+    groupId++;
+}
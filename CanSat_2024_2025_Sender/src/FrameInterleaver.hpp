@@ -0,0 +1,75 @@
+#ifndef FRAMEINTERLEAVER_HPP
+#define FRAMEINTERLEAVER_HPP
+
+#include <Arduino.h> // Core Arduino functionality
+#include <RS-FEC.h>  // Library for Reed-Solomon error correction (RS::Interleave)
+#include "Utils.hpp" // FRAME_HEADER_SIZE
+
+/**
+ * @class FrameInterleaver
+ * @brief Collects a group of encoded frames and spreads their codewords over one or more packets.
+ *
+ * The codewords of `depth` frames are padded to the longest one and byte-interleaved,
+ * so a burst of LoRa symbol errors hits every codeword only a few times. The interleaved
+ * stream is cut into chunks, and every packet repeats the group header with all frame headers:
+ *
+ *   [group id][depth][packet index << 4 | packet count][slot length][depth x frame header][chunk]
+ */
+class FrameInterleaver {
+public:
+    static const uint8_t MAX_DEPTH = 8;             // Most frames per group
+    static const size_t MAX_CODEWORD = 96 + 32;     // Longest Reed-Solomon codeword (message + ECC)
+    static const size_t MAX_CHUNK = 200;            // Most interleaved bytes per packet
+    static const size_t GROUP_HEADER_SIZE = 4;      // Group fields before the frame headers
+    static const size_t MAX_PACKET = GROUP_HEADER_SIZE + MAX_DEPTH * FRAME_HEADER_SIZE + MAX_CHUNK;
+
+    /**
+     * @brief Constructor for FrameInterleaver.
+     *
+     * @param depth Number of frames interleaved together (1 to MAX_DEPTH).
+     */
+    FrameInterleaver(uint8_t depth);
+
+    /**
+     * @brief Adds one encoded frame (frame header followed by the codeword) to the group.
+     *
+     * @param frame Pointer to the encoded frame.
+     * @param length Length of the encoded frame in bytes.
+     * @return True when the group is complete and its packets can be built.
+     */
+    bool addFrame(const char* frame, size_t length);
+
+    /**
+     * @brief Gets the number of packets the complete group is sent in.
+     *
+     * @return Number of packets.
+     */
+    size_t packetCount() const { return packets; }
+
+    /**
+     * @brief Builds one packet of the complete group.
+     *
+     * @param index Packet index, below packetCount().
+     * @param packet Buffer for the packet (MAX_PACKET bytes at least).
+     * @return Length of the packet in bytes.
+     */
+    size_t buildPacket(size_t index, uint8_t* packet) const;
+
+    /**
+     * @brief Starts the next group after all its packets were sent.
+     */
+    void nextGroup();
+
+private:
+    uint8_t depth;                                   // Frames per group
+    uint8_t frames;                                  // Frames collected so far
+    uint8_t groupId;                                 // Rolling group identifier
+    uint8_t headers[MAX_DEPTH * FRAME_HEADER_SIZE];  // Frame headers of the group
+    uint8_t codewords[MAX_DEPTH * MAX_CODEWORD];     // Codewords, MAX_CODEWORD apart
+    size_t lengths[MAX_DEPTH];                       // Codeword lengths
+    uint8_t stream[MAX_DEPTH * MAX_CODEWORD];        // Interleaved stream of the complete group
+    size_t slotLength;                               // Longest codeword of the group
+    size_t packets;                                  // Packets for the complete group
+};
+
+#endif // FRAMEINTERLEAVER_HPP
@@ -86,6 +86,15 @@ void GPSHandler::initialize(uint32_t baudRate) {
     Serial.println("GPS Initialized.");
 }
 
+/**
+ * @brief Passes the received GPS data to the parser.
+ * 
+ * Reads only what the software serial buffered so far, so it never blocks.
+ */
+void GPSHandler::update() {
+    smartDelay(0, gpsSerial, gps);
+}
+
 /**
  * @brief Reads and parses GPS data.
  * 
@@ -103,12 +112,13 @@ void GPSHandler::initialize(uint32_t baudRate) {
  * @param course Reference to store the course in degrees.
  * @param altitude Reference to store the altitude in meters.
  * @param satellites Reference to store the number of satellites in view.
+ * @param waitMs Time to collect GPS data before reading it in milliseconds.
  */
 void GPSHandler::readGPS(double& latitude, double& longitude, int& day, int& month, int& year,
                          int& hour, int& minute, int& second, double& speedKPH, double& course,
-                         double& altitude, uint32_t& satellites) {
-    // Process incoming GPS data for 500 milliseconds
-    smartDelay(500, gpsSerial, gps);
+                         double& altitude, uint32_t& satellites, unsigned long waitMs) {
+    // Process incoming GPS data for the requested time, at least what already arrived
+    smartDelay(waitMs, gpsSerial, gps);
 
     // Retrieve data parsed by TinyGPSPlus
     latitude = gps.location.lat();
@@ -59,6 +59,13 @@ public:
      */
     void initialize(uint32_t baudRate);
 
+    /**
+     * @brief Passes the GPS data received so far to the parser without waiting.
+     * 
+     * Call it every few milliseconds when readGPS() is used without a wait.
+     */
+    void update();
+
     /**
      * @brief Reads data from the GPS module.
      * 
@@ -76,10 +83,11 @@ public:
      * @param course Reference to store the course in degrees.
      * @param altitude Reference to store the altitude in meters.
      * @param satellites Reference to store the number of satellites in view.
+     * @param waitMs Time to collect GPS data before reading it in milliseconds, 0 to read the last parsed data.
      */
     void readGPS(double& latitude, double& longitude, int& day, int& month, int& year,
                  int& hour, int& minute, int& second, double& speedKPH, double& course,
-                 double& altitude, uint32_t& satellites);
+                 double& altitude, uint32_t& satellites, unsigned long waitMs = 500);
 };
 
 #endif // GPSHANDLER_HPP
@@ -13,7 +13,8 @@
  * @param sw The synchronization word for LoRa communication.
  */
 LoRaHandler::LoRaHandler(int cs, int rst, int dio0, float freq, int sf, int sw, long bw, int cr)
-    : csPin(cs), rstPin(rst), dio0Pin(dio0), frequency(freq), spreadingFactor(sf), syncWord(sw), bandwidth(bw), codingRate(cr) {}
+    : csPin(cs), rstPin(rst), dio0Pin(dio0), frequency(freq), spreadingFactor(sf), syncWord(sw), bandwidth(bw), codingRate(cr),
+      sequence(0) {}
 
 /**
  * @brief Initializes the LoRa module.
@@ -62,48 +63,81 @@ void LoRaHandler::deselect() {
 }
 
 /**
- * @brief Sends a data packet using the `LoRa.print` method.
+ * @brief Sends one packet: the LoRaPacket header, then the payload fields and the data.
  * 
- * This method prefixes the data with a "P:!" marker for debugging 
- * and sends the data as plain text over LoRa.
+ * Every packet gets the next sequence number, so the receiver can count lost packets
+ * from the gaps. The transmission runs in the background: the call returns once the
+ * packet is in the radio, and the next call waits for the end of the previous one,
+ * sleeping a tick at a time so the other tasks and the idle task of the core keep running.
+ * 
+ * @param type The packet type.
+ * @param fields Payload bytes sent before the data, or nullptr.
+ * @param fieldsSize Number of bytes in fields.
+ * @param data Pointer to the data to be sent.
+ * @param size Size of the data in bytes.
+ * @return True if the packet is handed to the radio, false if it does not fit one LoRa packet.
+ */
+bool LoRaHandler::sendPacket(LoRaPacket::Type type, const uint8_t* fields, size_t fieldsSize,
+                             const uint8_t* data, size_t size) {
+    if (fieldsSize + size > LoRaPacket::MAX_PAYLOAD) {
+        return false;
+    }
+
+    LoRaPacket::Header header = {type, sequence++, (uint8_t)(fieldsSize + size)};
+    uint8_t headerBytes[LoRaPacket::HEADER_SIZE];
+    LoRaPacket::writeHeader(header, headerBytes);
+
+    select(); // Select the LoRa module
+    while (!LoRa.beginPacket()) { // Refused while the previous packet is still on air
+        vTaskDelay(1); // Sleep instead of spinning, the task watchdog needs the idle task to run
+    }
+    LoRa.write(headerBytes, sizeof(headerBytes)); // Type, sequence number, length and header CRC
+    if (fieldsSize > 0) {
+        LoRa.write(fields, fieldsSize); // Payload fields in front of the data
+    }
+    LoRa.write(data, size); // Send the raw byte data
+    LoRa.endPacket(true); // Start the transmission without waiting for TxDone
+    deselect(); // Deselect the LoRa module
+    return true;
+}
+
+/**
+ * @brief Sends a Reed-Solomon frame as a LoRaPacket::TYPE_REED_SOLOMON packet.
  * 
  * @param data Pointer to the data array to be sent.
  * @param size Size of the data array.
  * @return True if the packet is sent successfully.
  */
 bool LoRaHandler::sendPacketWithPrint(const char* data, size_t size) {
-    select(); // Select the LoRa module
-    LoRa.beginPacket(); // Begin the LoRa packet
-
-    LoRa.print("P:!"); // Prefix for debugging
-    for (size_t i = 0; i < size; i++) {
-        LoRa.print(data[i]); // Send data as plain text
-    }
-    LoRa.println(); // End the data with a newline
-    LoRa.endPacket(); // Finalize the packet
-    deselect(); // Deselect the LoRa module
-    return true; // Return success
+    return sendPacket(LoRaPacket::TYPE_REED_SOLOMON, nullptr, 0, (const uint8_t*)data, size);
 }
 
 /**
- * @brief Sends a data packet using the `LoRa.write` method.
+ * @brief Sends a Turbo-coded frame as a LoRaPacket::TYPE_TURBO packet.
  * 
- * This method prefixes the data with a "W:!" marker for debugging, 
- * followed by the bit length, and sends the data as raw bytes over LoRa.
+ * The payload starts with the bit length (little-endian) and the puncturing,
+ * followed by the coded bytes.
  * 
- * @param data A vector containing the byte-encoded message to be sent.
+ * @param data Pointer to the byte-encoded message to be sent.
+ * @param size Size of the message in bytes.
  * @param bitLength The length of the data in bits.
+ * @param puncturing The TurboCodec::Puncturing the data was encoded with.
  * @return True if the packet is sent successfully.
  */
-bool LoRaHandler::sendPacketWithWrite(const std::vector<uint8_t>& data, uint16_t bitLength) {
-    select(); // Select the LoRa module
-    LoRa.beginPacket(); // Begin the LoRa packet
+bool LoRaHandler::sendPacketWithWrite(const uint8_t* data, size_t size, uint16_t bitLength, uint8_t puncturing) {
+    const uint8_t fields[TURBO_FIELDS_SIZE] = {(uint8_t)bitLength, (uint8_t)(bitLength >> 8), puncturing};
+    return sendPacket(LoRaPacket::TYPE_TURBO, fields, sizeof(fields), data, size);
+}
 
-    LoRa.print("W:!"); // Prefix for debugging
-    LoRa.write((uint8_t*)&bitLength, sizeof(bitLength)); // Send the bit length as raw data
-    LoRa.write(data.data(), data.size()); // Send the raw byte data
-    LoRa.println(); // End the data with a newline
-    LoRa.endPacket(); // Finalize the packet
-    deselect(); // Deselect the LoRa module
-    return true; // Return success
+/**
+ * @brief Sends one packet of an interleaved frame group as a LoRaPacket::TYPE_INTERLEAVED packet.
+ * 
+ * The payload is the group header, frame headers and interleaved codeword bytes.
+ * 
+ * @param data Pointer to the packet bytes.
+ * @param size Size of the packet in bytes.
+ * @return True if the packet is sent successfully.
+ */
+bool LoRaHandler::sendInterleavedPacket(const uint8_t* data, size_t size) {
+    return sendPacket(LoRaPacket::TYPE_INTERLEAVED, nullptr, 0, data, size);
 }
@@ -4,7 +4,10 @@
 #include <Arduino.h> // Core Arduino functionality
 #include <LoRa.h>    // Library for LoRa communication
 #include <SPI.h>     // SPI communication for LoRa module
+#include <freertos/FreeRTOS.h> // FreeRTOS kernel of the ESP32
+#include <freertos/task.h>     // vTaskDelay while a packet is on air
 #include <vector>    // Standard vector for handling byte arrays
+#include <LoRaPacket.h> // Binary packet header shared with the receiver
 
 /**
  * @class LoRaHandler
@@ -12,9 +15,12 @@
  * 
  * This class initializes the LoRa module, configures parameters such as
  * frequency, spreading factor, bandwidth, and coding rate, and provides
- * methods to send data packets using plain text or byte encoding.
+ * methods to send data packets behind a LoRaPacket header.
  */
 class LoRaHandler {
+public:
+    static const size_t TURBO_FIELDS_SIZE = 3; // Bit length and puncturing in front of the Turbo coded bytes
+
 private:
     int csPin;             // Chip Select (CS) pin for SPI communication
     int rstPin;            // Reset pin for LoRa module
@@ -24,6 +30,20 @@ private:
     int syncWord;          // Sync word for network separation
     long bandwidth;        // Signal bandwidth in Hz
     int codingRate;        // Coding rate for LoRa (e.g., 4/5)
+    uint16_t sequence;     // Sequence number of the next packet
+
+    /**
+     * @brief Sends one packet: the LoRaPacket header, then the payload fields and the data.
+     *        Returns once the packet is in the radio; the next call waits for its transmission.
+     * 
+     * @param type The packet type.
+     * @param fields Payload bytes sent before the data, or nullptr.
+     * @param fieldsSize Number of bytes in fields.
+     * @param data Pointer to the data to be sent.
+     * @param size Size of the data in bytes.
+     * @return True if the packet is handed to the radio, false if it does not fit one LoRa packet.
+     */
+    bool sendPacket(LoRaPacket::Type type, const uint8_t* fields, size_t fieldsSize, const uint8_t* data, size_t size);
 
 public:
     /**
@@ -65,9 +85,7 @@ public:
     void deselect();
 
     /**
-     * @brief Sends a data packet using the `LoRa.print` method.
-     * 
-     * This method includes a prefix for debugging and sends data as plain text.
+     * @brief Sends a Reed-Solomon frame as a LoRaPacket::TYPE_REED_SOLOMON packet.
      * 
      * @param data Pointer to the data array to be sent.
      * @param size Size of the data array.
@@ -76,15 +94,28 @@ public:
     bool sendPacketWithPrint(const char* data, size_t size);
 
     /**
-     * @brief Sends a data packet using the `LoRa.write` method.
+     * @brief Sends a Turbo-coded frame as a LoRaPacket::TYPE_TURBO packet.
      * 
-     * This method includes a prefix, followed by the bit length, and sends the data as raw bytes.
+     * The payload starts with the bit length and the puncturing, followed by the coded bytes.
      * 
-     * @param data A vector containing the byte-encoded message to be sent.
+     * @param data Pointer to the byte-encoded message to be sent.
+     * @param size Size of the message in bytes.
      * @param bitLength The length of the data in bits.
+     * @param puncturing The TurboCodec::Puncturing the data was encoded with.
+     * @return True if the packet is sent successfully.
+     */
+    bool sendPacketWithWrite(const uint8_t* data, size_t size, uint16_t bitLength, uint8_t puncturing);
+
+    /**
+     * @brief Sends one packet of an interleaved frame group as a LoRaPacket::TYPE_INTERLEAVED packet.
+     * 
+     * The payload is the packet built by FrameInterleaver.
+     * 
+     * @param data Pointer to the packet bytes.
+     * @param size Size of the packet in bytes.
      * @return True if the packet is sent successfully.
      */
-    bool sendPacketWithWrite(const std::vector<uint8_t>& data, uint16_t bitLength);
+    bool sendInterleavedPacket(const uint8_t* data, size_t size);
 };
 
 #endif // LORAHANDLER_HPP
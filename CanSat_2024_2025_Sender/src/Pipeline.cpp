@@ -0,0 +1,383 @@
+#include "Pipeline.hpp"
+#include "config.hpp"
+
+// Cores: the radio and the encoder share core 0 at the same priority, the radio sleeps while a packet
+// is on air; the sensor task keeps the barometer slots on core 1 above the log
+static const BaseType_t RADIO_CORE = 0;
+static const BaseType_t SENSOR_CORE = 1;
+
+static const UBaseType_t SENSOR_PRIORITY = 3;
+static const UBaseType_t ENCODE_PRIORITY = 2;
+static const UBaseType_t RADIO_PRIORITY = 2;
+static const UBaseType_t LOG_PRIORITY = 1;
+
+static const uint32_t SENSOR_STACK = 4096;
+static const uint32_t ENCODE_STACK = 8192;
+static const uint32_t RADIO_STACK = 4096;
+static const uint32_t LOG_STACK = 6144;
+
+// Pressure batch bytes per reading, the room left next to a key frame
+static const size_t MAX_BATCH = messageSize - TelemetryFrame::SIZE;
+
+static_assert(FRAME_HEADER_SIZE + messageSize + ECC_LENGTH <= LoRaPacket::MAX_PAYLOAD, "Frames exceed LoRa");
+static_assert(FrameInterleaver::MAX_PACKET <= LoRaPacket::MAX_PAYLOAD, "Interleaved packets exceed LoRa");
+
+/**
+ * @brief Readings from the sensor to the encode task.
+ */
+struct Reading {
+    uint8_t frame[TelemetryFrame::SIZE];  // Telemetry frame of the reading
+    uint8_t batch[MAX_BATCH];             // Pressure samples since the last reading
+    uint8_t batchLength;                  // Bytes in batch
+    uint32_t acquiredUs;                  // micros() when the reading was taken
+};
+
+/**
+ * @brief Packets from the encode to the radio task.
+ */
+struct RadioPacket {
+    LoRaPacket::Type type;                // Reed-Solomon, interleaved or Turbo packet
+    bool endsGroup;                       // Last packet of an interleaved group
+    uint8_t puncturing;                   // Turbo puncturing
+    uint16_t bitLength;                   // Turbo coded bits
+    uint16_t length;                      // Bytes in data
+    uint32_t acquiredUs;                  // micros() when the reading was taken
+    uint8_t data[LoRaPacket::MAX_PAYLOAD];  // Packet payload after the header and fields
+};
+
+/**
+ * @brief Readings from the sensor to the log task.
+ */
+struct LogEntry {
+    Telemetry sample;                     // The readings in sensor units
+    uint32_t acquiredUs;                  // micros() when the reading was taken
+};
+
+/**
+ * @brief Constructor for StageStats, starts with empty counters.
+ */
+StageStats::StageStats() : items(0), dropped(0), maxDepth(0), latencySumUs(0), latencyMaxUs(0) {}
+
+/**
+ * @brief Counts one item finished by the stage.
+ *
+ * @param latencyUs Time from the acquisition of the item to the end of this stage in microseconds.
+ */
+void StageStats::record(uint32_t latencyUs) {
+    taskENTER_CRITICAL(&lock);
+    items++;
+    latencySumUs += latencyUs;
+    if (latencyUs > latencyMaxUs) {
+        latencyMaxUs = latencyUs;
+    }
+    taskEXIT_CRITICAL(&lock);
+}
+
+/**
+ * @brief Counts one item the stage dropped or held back.
+ */
+void StageStats::drop() {
+    taskENTER_CRITICAL(&lock);
+    dropped++;
+    taskEXIT_CRITICAL(&lock);
+}
+
+/**
+ * @brief Tracks the fill level of the input queue of the stage.
+ *
+ * @param depth Items waiting in the queue.
+ */
+void StageStats::queueDepth(uint32_t depth) {
+    taskENTER_CRITICAL(&lock);
+    if (depth > maxDepth) {
+        maxDepth = depth;
+    }
+    taskEXIT_CRITICAL(&lock);
+}
+
+/**
+ * @brief Prints the counters and starts a new interval.
+ *
+ * @param name Name of the stage.
+ */
+void StageStats::report(const char* name) {
+    // Copy and clear under the lock, print outside of it
+    taskENTER_CRITICAL(&lock);
+    uint32_t itemCount = items;
+    uint32_t dropCount = dropped;
+    uint32_t depth = maxDepth;
+    uint64_t sumUs = latencySumUs;
+    uint32_t maxUs = latencyMaxUs;
+    items = dropped = maxDepth = latencyMaxUs = 0;
+    latencySumUs = 0;
+    taskEXIT_CRITICAL(&lock);
+
+    Serial.print(name);
+    Serial.print("=");
+    Serial.print(itemCount);
+    Serial.print(",");
+    Serial.print(dropCount);
+    Serial.print(",");
+    Serial.print(depth);
+    Serial.print(",");
+    Serial.print(itemCount > 0 ? (float)sumUs / itemCount / 1000.0F : 0.0F, 1);
+    Serial.print(",");
+    Serial.print(maxUs / 1000.0F, 1);
+}
+
+/**
+ * @brief Constructor for Pipeline. Nothing runs before begin().
+ */
+Pipeline::Pipeline()
+    : readings(nullptr), packets(nullptr), logEntries(nullptr), i2cMutex(nullptr), consoleMutex(nullptr) {}
+
+/**
+ * @brief Creates the queues and starts the tasks.
+ *
+ * @return True if every queue and task was created.
+ */
+bool Pipeline::begin() {
+    readings = xQueueCreate(READING_QUEUE_DEPTH, sizeof(Reading));
+    packets = xQueueCreate(PACKET_QUEUE_DEPTH, sizeof(RadioPacket));
+    logEntries = xQueueCreate(LOG_QUEUE_DEPTH, sizeof(LogEntry));
+    i2cMutex = xSemaphoreCreateMutex();
+    consoleMutex = xSemaphoreCreateMutex();
+    if (readings == nullptr || packets == nullptr || logEntries == nullptr || i2cMutex == nullptr ||
+        consoleMutex == nullptr) {
+        return false;
+    }
+
+    // Consumers first, so the first reading finds its stages running
+    return xTaskCreatePinnedToCore(radioTask, "radio", RADIO_STACK, this, RADIO_PRIORITY, nullptr,
+                                   RADIO_CORE) == pdPASS &&
+           xTaskCreatePinnedToCore(encodeTask, "encode", ENCODE_STACK, this, ENCODE_PRIORITY, nullptr,
+                                   RADIO_CORE) == pdPASS &&
+           xTaskCreatePinnedToCore(logTask, "log", LOG_STACK, this, LOG_PRIORITY, nullptr,
+                                   SENSOR_CORE) == pdPASS &&
+           xTaskCreatePinnedToCore(sensorTask, "sensor", SENSOR_STACK, this, SENSOR_PRIORITY, nullptr,
+                                   SENSOR_CORE) == pdPASS;
+}
+
+/**
+ * @brief Prints the counters of all stages as one "PIPELINE:" line.
+ */
+void Pipeline::printStats() {
+    xSemaphoreTake(consoleMutex, portMAX_DELAY);
+    Serial.print("PIPELINE:");
+    sensorStats.report("sensor");
+    Serial.print(";");
+    encodeStats.report("encode");
+    Serial.print(";");
+    radioStats.report("radio");
+    Serial.print(";");
+    logStats.report("log");
+    Serial.println();
+    xSemaphoreGive(consoleMutex);
+}
+
+void Pipeline::sensorTask(void* pipeline) {
+    static_cast<Pipeline*>(pipeline)->runSensor();
+}
+
+void Pipeline::encodeTask(void* pipeline) {
+    static_cast<Pipeline*>(pipeline)->runEncode();
+}
+
+void Pipeline::radioTask(void* pipeline) {
+    static_cast<Pipeline*>(pipeline)->runRadio();
+}
+
+void Pipeline::logTask(void* pipeline) {
+    static_cast<Pipeline*>(pipeline)->runLog();
+}
+
+/**
+ * @brief Sensor stage: GPS parsing and barometer slots every SENSOR_TICK_MS, a reading every frame interval.
+ */
+void Pipeline::runSensor() {
+    TickType_t wake = xTaskGetTickCount();
+    unsigned long lastFrameMs = millis() - FRAME_INTERVAL_MS;
+    bool held = false;
+
+    for (;;) {
+        gpsHandler.update();
+        xSemaphoreTake(i2cMutex, portMAX_DELAY);
+        pressureSampler.poll();
+        xSemaphoreGive(i2cMutex);
+
+        if (millis() - lastFrameMs >= FRAME_INTERVAL_MS) {
+            // A busy radio keeps the encode queue full: wait, the samples collect for the next batch
+            if (uxQueueSpacesAvailable(readings) == 0) {
+                if (!held) {
+                    sensorStats.drop();
+                    held = true;
+                }
+            } else {
+                held = false;
+                lastFrameMs = millis();
+                uint32_t startUs = micros();
+
+                Telemetry sample;
+                gpsHandler.readGPS(sample.latitude, sample.longitude, sample.day, sample.month, sample.year,
+                                   sample.hour, sample.minute, sample.second, sample.speedKPH, sample.course,
+                                   sample.altitude, sample.satellites, 0);
+                BMP280Data data = pressureSampler.latest();
+                sample.messageNumber = (uint16_t)messageNumber++;
+                sample.pressure = data.pressure;
+                sample.temperature = data.temperature;
+
+                Reading reading;
+                reading.acquiredUs = startUs;
+                TelemetryFrame::serialize(sample, reading.frame, sizeof(reading.frame));
+                reading.batchLength = (uint8_t)pressureSampler.takeBatch(reading.batch, sizeof(reading.batch),
+                                                                          TelemetryFrame::pressureField(reading.frame));
+                xQueueSend(readings, &reading, 0);
+                encodeStats.queueDepth(uxQueueMessagesWaiting(readings));
+
+                // The log only reports, it never holds back a frame
+                LogEntry entry = {sample, startUs};
+                if (xQueueSend(logEntries, &entry, 0) != pdTRUE) {
+                    logStats.drop();
+                }
+                logStats.queueDepth(uxQueueMessagesWaiting(logEntries));
+                sensorStats.record(micros() - startUs);
+            }
+        }
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(SENSOR_TICK_MS));
+    }
+}
+
+/**
+ * @brief Encode stage: compression, Reed-Solomon, interleaving and Turbo Codes of every reading.
+ */
+void Pipeline::runEncode() {
+    Reading reading;
+    RadioPacket packet;
+    char encoded[FRAME_HEADER_SIZE + messageSize + ECC_LENGTH];
+
+    for (;;) {
+        xQueueReceive(readings, &reading, portMAX_DELAY);
+
+        // Key or delta frame, followed by the barometer samples taken since the last reading
+        uint8_t telemetry[messageSize];
+        size_t telemetryLength = telemetryCompressor.compress(reading.frame, telemetry);
+        memcpy(telemetry + telemetryLength, reading.batch, reading.batchLength);
+        telemetryLength += reading.batchLength;
+
+        // Encode the telemetry using Reed-Solomon error correction
+        size_t frameLength = Utils::encodeMessage(telemetry, telemetryLength, encoded, sizeof(encoded),
+                                                  codeRates, codeRateIndex);
+
+        // Queue the frame on its own or, once its group is complete, the interleaved packets.
+        // A full queue blocks here until the radio catches up. The Turbo copy always follows, the
+        // receiver pairs copies and frames by this order (FrameDeinterleaver::turboSequence)
+        packet.acquiredUs = reading.acquiredUs;
+        packet.puncturing = 0;
+        packet.bitLength = 0;
+        if (INTERLEAVE_DEPTH <= 1) {
+            packet.type = LoRaPacket::TYPE_REED_SOLOMON;
+            packet.endsGroup = false;
+            packet.length = (uint16_t)frameLength;
+            memcpy(packet.data, encoded, frameLength);
+            xQueueSend(packets, &packet, portMAX_DELAY);
+        } else if (frameInterleaver.addFrame(encoded, frameLength)) {
+            packet.type = LoRaPacket::TYPE_INTERLEAVED;
+            for (size_t i = 0; i < frameInterleaver.packetCount(); i++) {
+                packet.endsGroup = i + 1 == frameInterleaver.packetCount();
+                packet.length = (uint16_t)frameInterleaver.buildPacket(i, packet.data);
+                xQueueSend(packets, &packet, portMAX_DELAY);
+            }
+            frameInterleaver.nextGroup();
+        }
+
+        // Encode the same telemetry using Turbo Codes, straight into the packet after its fields
+        uint16_t bitLength = turboCodec.encode(telemetry, telemetryLength, packet.data,
+                                               LoRaPacket::MAX_PAYLOAD - LoRaHandler::TURBO_FIELDS_SIZE, turboRate);
+        if (bitLength > 0) {
+            xSemaphoreTake(consoleMutex, portMAX_DELAY);
+            Serial.print("Turbo Codes Encoded Message: ");
+            Serial.print(bitLength);
+            Serial.println(" bits");
+            xSemaphoreGive(consoleMutex);
+            packet.type = LoRaPacket::TYPE_TURBO;
+            packet.endsGroup = false;
+            packet.puncturing = turboRate;
+            packet.bitLength = bitLength;
+            packet.length = (uint16_t)((bitLength + 7) / 8);
+            xQueueSend(packets, &packet, portMAX_DELAY);
+        } else {
+            xSemaphoreTake(consoleMutex, portMAX_DELAY);
+            Serial.println("Message too long for Turbo Codes, skipped.");
+            xSemaphoreGive(consoleMutex);
+        }
+        radioStats.queueDepth(uxQueueMessagesWaiting(packets));
+        encodeStats.record(micros() - reading.acquiredUs);
+    }
+}
+
+/**
+ * @brief Radio stage: sends every queued packet, the only task that touches the LoRa module.
+ */
+void Pipeline::runRadio() {
+    RadioPacket packet;
+
+    for (;;) {
+        xQueueReceive(packets, &packet, portMAX_DELAY);
+
+        const char* status = nullptr;
+        switch (packet.type) {
+        case LoRaPacket::TYPE_REED_SOLOMON:
+            loraHandler.sendPacketWithPrint((const char*)packet.data, packet.length);
+            status = "Reed-Solomon Message Sent.";
+            break;
+        case LoRaPacket::TYPE_INTERLEAVED:
+            loraHandler.sendInterleavedPacket(packet.data, packet.length);
+            if (packet.endsGroup) {
+                status = "Reed-Solomon Interleaved Group Sent.";
+            }
+            break;
+        case LoRaPacket::TYPE_TURBO:
+            loraHandler.sendPacketWithWrite(packet.data, packet.length, packet.bitLength, packet.puncturing);
+            break;
+        }
+        radioStats.record(micros() - packet.acquiredUs);
+
+        if (status != nullptr) {
+            xSemaphoreTake(consoleMutex, portMAX_DELAY);
+            Serial.println(status);
+            xSemaphoreGive(consoleMutex);
+        }
+    }
+}
+
+/**
+ * @brief Log stage: Serial, SD card and OLED, all off the radio path.
+ */
+void Pipeline::runLog() {
+    LogEntry entry;
+
+    for (;;) {
+        xQueueReceive(logEntries, &entry, portMAX_DELAY);
+
+        // Format the readable data line into a fixed buffer, without heap use
+        char dataLine[TelemetryFrame::TEXT_SIZE];
+        TelemetryFrame::format(entry.sample, dataLine, sizeof(dataLine));
+        xSemaphoreTake(consoleMutex, portMAX_DELAY);
+        Serial.println(dataLine);
+        xSemaphoreGive(consoleMutex);
+
+        // Save the readable data line to the SD card
+        if (!sdHandler.writeFile("/CS2425.TXT", dataLine)) {
+            xSemaphoreTake(consoleMutex, portMAX_DELAY);
+            Serial.println("Error writing to CS2425.TXT.");
+            xSemaphoreGive(consoleMutex);
+        }
+
+        // Update OLED display with the latest readings; the BMP280 waits for the bus meanwhile
+        xSemaphoreTake(i2cMutex, portMAX_DELAY);
+        Utils::updateOLED(oledHandler, entry.sample.latitude, entry.sample.longitude, entry.sample.altitude,
+                          entry.sample.temperature, entry.sample.pressure);
+        xSemaphoreGive(i2cMutex);
+        logStats.record(micros() - entry.acquiredUs);
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <Arduino.h>            // Core Arduino functionality
+#include <freertos/FreeRTOS.h>  // FreeRTOS kernel of the ESP32
+#include <freertos/queue.h>     // Bounded queues between the stages
+#include <freertos/semphr.h>    // Mutexes of the shared I2C bus and Serial
+#include <freertos/task.h>      // One task per stage
+
+/**
+ * @class StageStats
+ * @brief Counters of one pipeline stage over the current report interval.
+ *
+ * Updated by the task of the stage and read by the task that reports them,
+ * so every access goes through a critical section.
+ */
+class StageStats {
+public:
+    /**
+     * @brief Constructor for StageStats, starts with empty counters.
+     */
+    StageStats();
+
+    /**
+     * @brief Counts one item finished by the stage.
+     *
+     * @param latencyUs Time from the acquisition of the item to the end of this stage in microseconds.
+     */
+    void record(uint32_t latencyUs);
+
+    /**
+     * @brief Counts one item the stage dropped or held back.
+     */
+    void drop();
+
+    /**
+     * @brief Tracks the fill level of the input queue of the stage.
+     *
+     * @param depth Items waiting in the queue.
+     */
+    void queueDepth(uint32_t depth);
+
+    /**
+     * @brief Prints the counters as "name=items,dropped,max queue depth,average ms,max ms"
+     *        and starts a new interval.
+     *
+     * @param name Name of the stage.
+     */
+    void report(const char* name);
+
+private:
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED; // Guards the counters against the reporting task
+    uint32_t items;         // Items finished in the interval
+    uint32_t dropped;       // Items dropped or held back in the interval
+    uint32_t maxDepth;      // Highest input queue fill level in the interval
+    uint64_t latencySumUs;  // Sum of the item latencies in the interval
+    uint32_t latencyMaxUs;  // Highest item latency in the interval
+};
+
+/**
+ * @class Pipeline
+ * @brief Runs the sender as FreeRTOS tasks connected by bounded queues, spread over both cores.
+ *
+ * sensor (core 1): feeds the GPS parser, samples the BMP280 at its fixed rate and builds a reading
+ *                  every frame interval, as soon as the encode queue has room.
+ * encode (core 0): delta compression, Reed-Solomon, interleaving and Turbo Codes of every reading.
+ * radio  (core 0): sends the packets over LoRa and sleeps while one is on air; a full packet queue
+ *                  stalls encode, which keeps the readings back, so the frame rate follows the radio
+ *                  airtime while sensor sampling never waits for the radio.
+ * log    (core 1): prints every reading, writes it to the SD card and redraws the OLED.
+ *
+ * Every task prints to Serial, so each line goes out under a mutex and lines never mix.
+ */
+class Pipeline {
+public:
+    /**
+     * @brief Constructor for Pipeline. Nothing runs before begin().
+     */
+    Pipeline();
+
+    /**
+     * @brief Creates the queues and starts the tasks. Call it once at the end of setup(),
+     *        after every handler was initialized.
+     *
+     * @return True if every queue and task was created.
+     */
+    bool begin();
+
+    /**
+     * @brief Prints the counters of all stages as one "PIPELINE:" line and starts a new interval.
+     *        Format: "PIPELINE:" followed by "sensor=", "encode=", "radio=" and "log=" entries
+     *        separated by ';', each with items, dropped, max input queue depth, average and max
+     *        latency in ms. The latency counts from the acquisition of the reading. Sensor counts
+     *        the readings held back by a full encode queue as dropped, log the readings lost
+     *        on a full log queue.
+     */
+    void printStats();
+
+private:
+    /**
+     * @brief Task entry points, the parameter is the Pipeline.
+     *
+     * @param pipeline The Pipeline instance.
+     */
+    static void sensorTask(void* pipeline);
+    static void encodeTask(void* pipeline);
+    static void radioTask(void* pipeline);
+    static void logTask(void* pipeline);
+
+    /**
+     * @brief Stage loops, never return.
+     */
+    void runSensor();
+    void runEncode();
+    void runRadio();
+    void runLog();
+
+    QueueHandle_t readings;       // Sensor to encode
+    QueueHandle_t packets;        // Encode to radio
+    QueueHandle_t logEntries;     // Sensor to log
+    SemaphoreHandle_t i2cMutex;   // I2C bus shared by the BMP280 and the OLED
+    SemaphoreHandle_t consoleMutex; // Serial, held for whole lines
+
+    StageStats sensorStats;       // Reading acquisition
+    StageStats encodeStats;       // Reading to packets
+    StageStats radioStats;        // Reading to the last packet handed to the radio
+    StageStats logStats;          // Reading to the SD card and OLED
+};
+
+#endif // PIPELINE_HPP
@@ -0,0 +1,77 @@
+#include "PressureSampler.hpp"
+
+/**
+ * @brief Constructor for PressureSampler.
+ *
+ * @param bmp Handler of the BMP280 sensor to read.
+ * @param periodMs Time between two sample slots in milliseconds.
+ */
+PressureSampler::PressureSampler(BMP280Handler& bmp, uint8_t periodMs)
+    : bmp(bmp), periodMs(periodMs > 0 ? periodMs : 1), startMs(0), nextSlot(0), count(0), dropped(0) {
+    last.temperature = NAN;
+    last.pressure = NAN;
+}
+
+/**
+ * @brief Starts the slot grid at the current time and takes the first sample.
+ */
+void PressureSampler::begin() {
+    startMs = millis();
+    nextSlot = 0;
+    count = 0;
+    poll();
+}
+
+/**
+ * @brief Reads the sensor if a sample slot is due.
+ *
+ * When several slots passed since the last read, only the latest one is read;
+ * the skipped slots show up as a gap in the batch.
+ */
+void PressureSampler::poll() {
+    uint32_t slot = (millis() - startMs) / periodMs;
+    if (slot < nextSlot) {
+        return;
+    }
+    nextSlot = slot + 1;
+
+    BMP280Data data = bmp.getData();
+    if (isnan(data.pressure)) {
+        return; // A failed read is a missed slot
+    }
+    last = data;
+
+    // Keep the newest samples if the frames stop taking them
+    if (count == CAPACITY) {
+        memmove(samples, samples + 1, (CAPACITY - 1) * sizeof(samples[0]));
+        count--;
+        dropped++;
+    }
+    samples[count].pressure = (uint32_t)lroundf(data.pressure * 100.0F); // hPa to Pa
+    samples[count].slot = slot;
+    count++;
+}
+
+/**
+ * @brief Encodes the buffered samples as a PressureBatch and removes them.
+ *
+ * @param out Buffer for the batch.
+ * @param outSize Size of the buffer in bytes.
+ * @param referencePa Pressure field of the frame the batch is sent with, in Pa.
+ * @return Length of the batch in bytes.
+ */
+size_t PressureSampler::takeBatch(uint8_t* out, size_t outSize, uint32_t referencePa) {
+    if (count == 0) {
+        return 0;
+    }
+
+    // Age of the first sample, its slot start is the time it was due
+    unsigned long age = millis() - (startMs + samples[0].slot * periodMs);
+    uint16_t ageMs = age < 0xFFFF ? (uint16_t)age : 0xFFFF;
+
+    size_t used;
+    size_t length = PressureBatch::encode(samples, count, periodMs, ageMs, referencePa, out, outSize, used);
+    memmove(samples, samples + used, (count - used) * sizeof(samples[0]));
+    count -= used;
+    return length;
+}
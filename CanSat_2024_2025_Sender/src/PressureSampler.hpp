@@ -0,0 +1,75 @@
+#ifndef PRESSURESAMPLER_HPP
+#define PRESSURESAMPLER_HPP
+
+#include <Arduino.h>          // Core Arduino functionality
+#include <PressureBatch.h>    // Encoding of the samples sent with every frame
+#include "BMP280Handler.hpp"  // Handler for BMP280 sensor
+
+/**
+ * @class PressureSampler
+ * @brief Reads the BMP280 on a fixed grid of sample slots, independent of the radio cycle,
+ *        and hands the buffered samples to every outgoing frame as a PressureBatch.
+ *
+ * poll() must be called often; the sensor task of Pipeline calls it every SENSOR_TICK_MS.
+ * A slot that passes while the sensor is blocked is missed, not read late; the batch
+ * records the gap, so the receiver still knows the time of every sample.
+ */
+class PressureSampler {
+public:
+    static const size_t CAPACITY = 64; // Samples buffered between two frames, 2.5 s at 25 Hz
+
+    /**
+     * @brief Constructor for PressureSampler.
+     *
+     * @param bmp Handler of the BMP280 sensor to read.
+     * @param periodMs Time between two sample slots in milliseconds.
+     */
+    PressureSampler(BMP280Handler& bmp, uint8_t periodMs);
+
+    /**
+     * @brief Starts the slot grid at the current time and takes the first sample.
+     */
+    void begin();
+
+    /**
+     * @brief Reads the sensor if a sample slot is due; cheap when none is.
+     */
+    void poll();
+
+    /**
+     * @brief Gets the most recent reading.
+     *
+     * @return Temperature and pressure of the last sample.
+     */
+    BMP280Data latest() const { return last; }
+
+    /**
+     * @brief Encodes the buffered samples, oldest first, as a PressureBatch and removes them.
+     *        Samples that do not fit stay buffered for the next frame.
+     *
+     * @param out Buffer for the batch.
+     * @param outSize Size of the buffer in bytes.
+     * @param referencePa Pressure field of the frame the batch is sent with, in Pa.
+     * @return Length of the batch in bytes, 0 if no sample was buffered or none fits.
+     */
+    size_t takeBatch(uint8_t* out, size_t outSize, uint32_t referencePa);
+
+    /**
+     * @brief Gets the number of samples dropped because the buffer was full.
+     *
+     * @return Dropped samples since begin().
+     */
+    uint32_t droppedSamples() const { return dropped; }
+
+private:
+    BMP280Handler& bmp;                             // Sensor to read
+    uint8_t periodMs;                               // Time between two sample slots
+    unsigned long startMs;                          // millis() of slot 0
+    uint32_t nextSlot;                              // First slot not read yet
+    PressureBatch::Sample samples[CAPACITY];        // Buffered samples, oldest first
+    size_t count;                                   // Number of buffered samples
+    BMP280Data last;                                // Most recent reading
+    uint32_t dropped;                               // Samples dropped on a full buffer
+};
+
+#endif // PRESSURESAMPLER_HPP
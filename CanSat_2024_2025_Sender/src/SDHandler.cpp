@@ -38,7 +38,7 @@ bool SDHandler::initialize() {
  * @param data The data to write to the file.
  * @return True if the data is written successfully, False otherwise.
  */
-bool SDHandler::writeFile(const char* filename, const String& data) {
+bool SDHandler::writeFile(const char* filename, const char* data) {
     select(); // Enable communication
     File file = SD.open(filename, FILE_WRITE); // Open file in write mode
     if (file) {
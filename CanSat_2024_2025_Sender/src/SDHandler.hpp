@@ -47,7 +47,7 @@ public:
      * @param data The data to write to the file.
      * @return True if the data is written successfully, False otherwise.
      */
-    bool writeFile(const char* filename, const String& data);
+    bool writeFile(const char* filename, const char* data);
 
     /**
      * @brief Creates a new file on the SD card.
@@ -1,71 +1,35 @@
 #include "Utils.hpp"
 
 /**
- * @brief Creates a formatted data string from telemetry and sensor data.
+ * @brief Encodes a message using a shortened Reed-Solomon code.
  * 
- * Combines all input parameters into a single, comma-separated string for transmission or storage.
+ * The message is the telemetry frame itself, without padding; the code treats
+ * the missing bytes as zeros that are never sent.
  * 
- * @param messageNumber The message counter.
- * @param latitude Latitude in degrees.
- * @param longitude Longitude in degrees.
- * @param day Day of the date.
- * @param month Month of the date.
- * @param year Year of the date.
- * @param hour Current hour.
- * @param minute Current minute.
- * @param second Current second.
- * @param speedKPH Speed in km/h.
- * @param course Course in degrees.
- * @param altitude Altitude in meters.
- * @param satellites Number of satellites in view.
- * @param pressure Atmospheric pressure in hPa.
- * @param temperature Temperature in Celsius.
- * @return A formatted string containing the input data.
- */
-String Utils::createDataString(int messageNumber, double latitude, double longitude, int day,
-                               int month, int year, int hour, int minute, int second,
-                               double speedKPH, double course, double altitude,
-                               uint32_t satellites, double pressure, double temperature) {
-    return String(messageNumber) + "," +
-           String(latitude, 6) + "," +
-           String(longitude, 6) + "," +
-           String(day) + "/" + String(month) + "/" + String(year) + "," +
-           String(hour) + ":" + String(minute) + ":" + String(second) + "," +
-           String(speedKPH) + "," +
-           String(course) + "," +
-           String(altitude) + "," +
-           String(satellites) + "," +
-           String(pressure) + "," +
-           String(temperature);
-}
-
-/**
- * @brief Encodes a message using Reed-Solomon error correction.
- * 
- * Pads the message with zeros to the required size and encodes it for reliable communication.
- * 
- * @param dataString The input data string to encode.
- * @param message Buffer to store the padded message.
- * @param messageSize Size of the message buffer.
- * @param encoded Buffer to store the encoded data.
+ * @param data The telemetry frame to encode.
+ * @param length Length of the telemetry frame in bytes.
+ * @param encoded Buffer to store the encoded frame.
  * @param encodedSize Size of the encoded buffer.
- * @param rs Reference to the Reed-Solomon encoder.
+ * @param rates Table of available code rates.
+ * @param rateIndex Index of the code rate to use for this frame.
+ * @return Length of the encoded frame in bytes, 0 if it does not fit the buffer.
  */
-void Utils::encodeMessage(const String& dataString, char* message, size_t messageSize,
-                          char* encoded, size_t encodedSize, RS::ReedSolomon<96, 32>& rs) {
-    memset(message, 0, messageSize); // Clear the message buffer
-
-    size_t dataStringLength = dataString.length(); // Get the length of the data string
-    for (size_t i = 0; i < dataStringLength && i < messageSize; i++) {
-        message[i] = dataString[i]; // Copy data into the buffer
+size_t Utils::encodeMessage(const uint8_t* data, size_t length, char* encoded, size_t encodedSize,
+                            const RS::CodeRate* rates, uint8_t rateIndex) {
+    const RS::CodeRate& rate = rates[rateIndex];
+
+    // A binary frame cannot be cut short, so a frame that does not fit is not sent
+    size_t frameLength = FRAME_HEADER_SIZE + length + rate.ecc_length;
+    if (length == 0 || length > rate.msg_length || frameLength > encodedSize) {
+        return 0;
     }
 
-    for (size_t i = dataStringLength; i < messageSize; i++) {
-        message[i] = '0'; // Pad with zeros if needed
-    }
-    message[dataStringLength] = ','; // Add a separator at the end
+    // Header: message length, then the rate index with its complement in the high nibble
+    encoded[0] = (char)length;
+    encoded[1] = (char)((rateIndex & 0x0F) | ((~rateIndex & 0x0F) << 4));
 
-    rs.Encode(message, encoded); // Perform Reed-Solomon encoding
+    rate.encode(data, length, encoded + FRAME_HEADER_SIZE); // Perform Reed-Solomon encoding
+    return frameLength;
 }
 
 /**
@@ -91,34 +55,3 @@ void Utils::updateOLED(OLEDHandler& oledHandler, double latitude, double longitu
     oledHandler.printText(OLEDHandler::row6, "Press: " + String(pressure) + " hPa", 1); // Pressure
     oledHandler.display(); // Render the updated display
 }
-
-/**
- * @brief Converts a binary string into a vector of bits.
- * 
- * @param input The input binary string.
- * @param bitInput Vector to store the resulting bits.
- */
-void Utils::vectorToBits(const std::string& input, std::vector<uint8_t>& bitInput) {
-    for (char c : input) {
-        bitInput.push_back(c == '1' ? 1 : 0); // Convert '1' to 1 and '0' to 0
-    }
-}
-
-/**
- * @brief Converts a vector of bits into a vector of bytes.
- * 
- * @param bits The input vector of bits.
- * @param bytes Vector to store the resulting bytes.
- * @param bitLength The length of the bit stream.
- */
-void Utils::bitsToBytes(const std::vector<uint8_t>& bits, std::vector<uint8_t>& bytes, uint16_t& bitLength) {
-    bitLength = bits.size(); // Record the total bit length
-    size_t byteCount = (bitLength + 7) / 8; // Calculate the number of bytes needed
-    bytes.resize(byteCount, 0); // Resize the output byte vector
-
-    for (size_t i = 0; i < bitLength; i++) {
-        if (bits[i]) {
-            bytes[i / 8] |= (1 << (7 - (i % 8))); // Set the corresponding bit in the byte
-        }
-    }
-}
@@ -5,6 +5,9 @@
 // Instance of BMP280Handler to manage the BMP280 sensor
 BMP280Handler bmpHandler(BMP_SDA, BMP_SCL, BMP_ADDR);
 
+// Fixed-rate barometer sampling, independent of the radio cycle
+PressureSampler pressureSampler(bmpHandler, BMP_SAMPLE_PERIOD_MS);
+
 // Instance of GPSHandler to manage the GPS module
 GPSHandler gpsHandler(GPS_RX, GPS_TX, GPS_BAUD);
 
@@ -17,16 +20,37 @@ OLEDHandler oledHandler(OLED_SDA, OLED_SCL, OLED_RST, OLED_ADDR, SCREEN_WIDTH, S
 // Instance of SDHandler to manage the SD card
 SDHandler sdHandler(SD_CS, SD_MOSI, SD_MISO, SD_CLK);
 
-// *** Buffers for Encoding and Message Storage ***
+// *** Reed-Solomon Encoding ***
+
+// Reed-Solomon code rates, weakest first; the frame header tells the receiver which one was used
+const RS::CodeRate codeRates[CODE_RATE_COUNT] = {
+    RS::ShortenedCode<messageSize, 8>::rate(),
+    RS::ShortenedCode<messageSize, 16>::rate(),
+    RS::ShortenedCode<messageSize, ECC_LENGTH>::rate(),
+};
+
+// Start with the strongest code, lower it for shorter airtime on a good link
+uint8_t codeRateIndex = CODE_RATE_COUNT - 1;
+
+// Interleaver for groups of INTERLEAVE_DEPTH frames
+FrameInterleaver frameInterleaver(INTERLEAVE_DEPTH);
+
+// Key and delta frames of the telemetry, restarted by every key frame
+TelemetryCompressor telemetryCompressor(TELEMETRY_KEY_INTERVAL);
+
+// *** Turbo Codes Encoder and Buffer ***
+
+// Turbo encoder, kept global so its interleaver buffer is not rebuilt on the stack every loop
+TurboCodec turboCodec;
 
-// Message buffer used to store raw data before encoding
-char message[messageSize];
+// Rate 1/2 keeps a full message inside one LoRa packet; 1/3 gives the most coding gain and
+// 2/3 the shortest airtime under the duty-cycle limit
+TurboCodec::Puncturing turboRate = TurboCodec::RATE_1_2;
 
-// Encoded message buffer to store the output of Reed-Solomon encoding
-char encoded[messageSize + ECC_LENGTH];
+// *** Task Pipeline ***
 
-// Reed-Solomon encoder instance with specified message size and error correction length
-RS::ReedSolomon<messageSize, ECC_LENGTH> rs;
+// Sensor, encode, radio and log tasks, started at the end of setup()
+Pipeline pipeline;
 
 // *** Global Variables ***
 
@@ -9,6 +9,11 @@
 #include "SDHandler.hpp"      // Handler for SD card operations
 #include "TurboCodec.h"       // Library for Turbo Codes encoding/decoding
 #include "Utils.hpp"          // Utility functions
+#include "FrameInterleaver.hpp" // Interleaving of frame groups against burst errors
+#include "TelemetryFrame.h"   // Binary telemetry frame sent over LoRa
+#include "TelemetryCompressor.h" // Key and delta frames of the telemetry
+#include "PressureSampler.hpp" // Fixed-rate barometer samples sent with every frame
+#include "Pipeline.hpp"       // Sensor, encode, radio and log tasks
 #include <mySD.h>             // Library for SD card functionality
 #include <RS-FEC.h>           // Library for Reed-Solomon error correction
 
@@ -20,6 +25,11 @@
 
 extern BMP280Handler bmpHandler; // Global instance of the BMP280 handler
 
+// Barometer sample period, 25 Hz; the samples between two frames are sent with the next one
+#define BMP_SAMPLE_PERIOD_MS 40
+
+extern PressureSampler pressureSampler; // Reads the BMP280 on a fixed grid of sample slots
+
 // *** GPS Module Configuration ***
 // Pins for GPS communication
 #define GPS_TX 33      // Transmit pin for GPS
@@ -57,13 +67,30 @@ extern OLEDHandler oledHandler; // Global instance of the OLED handler
 
 // *** Reed-Solomon Error Correction Configuration ***
 // Error correction constants
-const uint8_t ECC_LENGTH = 32; // Length of the error correction code
-const int messageSize = 96;    // Size of the message in bytes
+const uint8_t ECC_LENGTH = 32; // Length of the strongest error correction code
+const int messageSize = 96;    // Largest message in bytes, shorter messages are sent without padding
+const int CODE_RATE_COUNT = 3; // Number of pre-instantiated ECC strengths
+
+// Shortened Reed-Solomon codes with 8, 16 and 32 ECC bytes, selected per frame
+extern const RS::CodeRate codeRates[CODE_RATE_COUNT];
+extern uint8_t codeRateIndex; // Index into codeRates used for the next frame
+
+// Frames interleaved per group; 1 sends every frame on its own as a "P" packet.
+// Depth D survives bursts of about D times the ECC/2 bytes, at the cost of D frames of latency
+#define INTERLEAVE_DEPTH 4
+
+extern FrameInterleaver frameInterleaver; // Collects frame groups for interleaving
 
-// Buffers for message and encoded data
-extern char message[messageSize];
-extern char encoded[messageSize + ECC_LENGTH];
-extern RS::ReedSolomon<messageSize, ECC_LENGTH> rs; // Reed-Solomon encoder instance
+// *** Telemetry Compression Configuration ***
+// Frames per key frame; the others are sent as deltas against it at roughly half the size.
+// A lost key frame makes the receiver drop the deltas up to the next one
+#define TELEMETRY_KEY_INTERVAL 8
+
+extern TelemetryCompressor telemetryCompressor; // Turns telemetry frames into key and delta frames
+
+// *** Turbo Codes Configuration ***
+extern TurboCodec turboCodec; // Turbo encoder of the "W" packets
+extern TurboCodec::Puncturing turboRate; // Puncturing of the "W" packets, sent in their header
 
 // *** SD Card Module Configuration ***
 // Pins for SD card communication
@@ -74,6 +101,18 @@ extern RS::ReedSolomon<messageSize, ECC_LENGTH> rs; // Reed-Solomon encoder inst
 
 extern SDHandler sdHandler; // Global instance of the SD handler
 
+// *** Task Pipeline Configuration ***
+// Shortest time between two frames; while the radio is still busy the next frame waits
+// and the barometer samples collect for it, so the frame rate follows the airtime
+#define FRAME_INTERVAL_MS 500
+#define SENSOR_TICK_MS 5                 // Sensor task period: GPS parsing and barometer slots
+#define READING_QUEUE_DEPTH 2            // Readings waiting for the encoder
+#define PACKET_QUEUE_DEPTH 8             // Packets waiting for the radio, an interleaved group and its Turbo packets
+#define LOG_QUEUE_DEPTH 4                // Readings waiting for Serial, SD card and OLED
+#define PIPELINE_STATS_INTERVAL_MS 5000  // Time between two "PIPELINE:" lines
+
+extern Pipeline pipeline; // Tasks and queues of the sender
+
 // *** Other Variables ***
 // Global message counter for tracking transmitted messages
 extern int messageNumber;
@@ -63,8 +63,9 @@ void setup() {
     oledHandler.printText(OLEDHandler::row1, "Initializing...", 1);
     oledHandler.display();
 
-    // Initialize BMP280 sensor
+    // Initialize BMP280 sensor and start sampling it
     bmpHandler.begin();
+    pressureSampler.begin();
     oledHandler.printText(OLEDHandler::row2, "BMP280 Ready!", 1);
     oledHandler.display();
 
@@ -97,88 +98,21 @@ void setup() {
     }
 
     Serial.println("Setup done!");
+
+    // Hand sensing, encoding, transmission and logging to their tasks; from here on Serial
+    // is shared, and every line goes through the pipeline's console mutex
+    if (!pipeline.begin()) {
+        Serial.println("Pipeline start failed!");
+        while (1); // Halt execution without the tasks
+    }
 }
 
 /**
  * @brief Main program loop executed repeatedly after setup.
+ *
+ * The work runs in the Pipeline tasks; the loop only reports their counters.
  */
 void loop() {
-    // Read data from the BMP280 sensor (temperature and pressure)
-    BMP280Data data = bmpHandler.getData();
-
-    // Variables for GPS data
-    double latitude, longitude, altitude;
-    int day, month, year, hour, minute, second;
-    double speedKPH, course, pressure, temperature;
-    uint32_t satellites;
-
-    // Read pressure and temperature from BMP280
-    pressure = data.pressure;
-    temperature = data.temperature;
-
-    // Read data from the GPS module
-    gpsHandler.readGPS(latitude, longitude, day, month, year, hour, minute, second,
-                        speedKPH, course, altitude, satellites);
-
-    // Create a formatted string of data
-    String dataString = Utils::createDataString(messageNumber, latitude, longitude, day, month, year,
-                                                hour, minute, second, speedKPH, course, altitude,
-                                                satellites, pressure, temperature);
-
-    // Print the data string for debugging
-    Serial.println(dataString);
-
-    // Encode the data string using Reed-Solomon error correction
-    Utils::encodeMessage(dataString, message, messageSize, encoded, sizeof(encoded), rs);
-
-    // Print the encoded message for debugging
-    // Serial.print("Encoded message (Reed-Solomon): ");
-    // Serial.write(encoded, sizeof(encoded));
-    // Serial.println();
-
-    // Transmit the encoded message via LoRa
-    loraHandler.sendPacketWithPrint(encoded, sizeof(encoded));
-    Serial.println("Reed-Solomon Message Sent.");
-
-    // Encode the data using Turbo Codes
-    TurboCodec codec;
-    std::string encodedMessage = codec.encode(dataString.c_str());
-
-    // Print the Turbo Codes encoded message
-    Serial.print("Turbo Codes Encoded Message: ");
-    Serial.println(encodedMessage.c_str());
-
-    // Convert the Turbo Codes message into a byte format for LoRa transmission
-    std::vector<uint8_t> byteMessage;
-    std::vector<uint8_t> bitVectorEncodedMessage;
-    uint16_t bitLength;
-
-    Utils::vectorToBits(encodedMessage, bitVectorEncodedMessage);
-    Utils::bitsToBytes(bitVectorEncodedMessage, byteMessage, bitLength);
-
-    // Print the byte array for verification
-    // Serial.print("Byte Message: ");
-    // for (uint8_t byte : byteMessage) {
-    //     Serial.print(byte, BIN);
-    //     Serial.print(" ");
-    // }
-    // Serial.println();
-
-    // Send the byte-encoded message via LoRa
-    // Serial.print("Sending message with Bit Length: ");
-    // Serial.println(bitLength);
-
-    loraHandler.sendPacketWithWrite(byteMessage, bitLength);
-    // Serial.println("Turbo Codes Message Sent.");
-
-    // Save the raw data string to the SD card
-    if (!sdHandler.writeFile("/CS2425.TXT", dataString)) {
-        Serial.println("Error writing to CS2425.TXT.");
-    }
-
-    // Update OLED display with the latest readings
-    Utils::updateOLED(oledHandler, latitude, longitude, altitude, temperature, pressure);
-
-    // Increment the message counter for the next loop
-    messageNumber++;
+    delay(PIPELINE_STATS_INTERVAL_MS);
+    pipeline.printStats();
 }